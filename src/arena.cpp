@@ -0,0 +1,27 @@
+#include "tuilight/arena.h"
+
+namespace wibens::tuilight
+{
+
+namespace
+{
+thread_local Arena *activeArena = nullptr;
+} // namespace
+
+void Arena::reset()
+{
+    while (destructors != nullptr) {
+        auto *record = destructors;
+        destructors = record->next;
+        record->destroy(record->object);
+    }
+    resource.release();
+}
+
+Arena::Scope::Scope(Arena &arena) : previous(activeArena) { activeArena = &arena; }
+
+Arena::Scope::~Scope() { activeArena = previous; }
+
+Arena *Arena::current() { return activeArena; }
+
+} // namespace wibens::tuilight
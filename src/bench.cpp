@@ -0,0 +1,351 @@
+#include "tuilight/arena.h"
+#include "tuilight/debug.h"
+#include "tuilight/element.h"
+#include "tuilight/headless.h"
+#include "tuilight/input.h"
+#include "tuilight/output.h"
+#include "tuilight/sgr.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace wibens::tuilight;
+
+namespace
+{
+
+struct Result {
+    std::size_t frames;
+    double nsPerFrame;
+    double bytesPerFrame;
+    double allocationsPerFrame;
+};
+
+// One unit of work per call, returns the number of bytes it emitted
+using Workload = std::function<std::size_t()>;
+
+Result measure(const Workload &frame, std::size_t frames)
+{
+    for (std::size_t i = 0; i < std::min<std::size_t>(frames / 10 + 1, 100); ++i) {
+        frame();
+    }
+    std::size_t bytes{};
+    debug::AllocationCounter allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < frames; ++i) {
+        bytes += frame();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return {frames, elapsed / frames, static_cast<double>(bytes) / frames,
+            static_cast<double>(allocations.count()) / frames};
+}
+
+// Renders the root of a headless terminal each frame, after an optional change, and encodes the diff
+struct RenderBench {
+    RenderBench(std::size_t width, std::size_t height, BaseElement root, std::function<void(HeadlessTerminal &)> change)
+        : terminal(width, height), out(-1), change(std::move(change))
+    {
+        terminal.setRoot(root);
+    }
+
+    std::size_t operator()()
+    {
+        if (change) {
+            change(terminal);
+        }
+        terminal.render();
+        auto bytes = terminal.encodeFrame(out);
+        out.discard();
+        return bytes;
+    }
+
+    HeadlessTerminal terminal;
+    OutputBuffer out;
+    std::function<void(HeadlessTerminal &)> change;
+};
+
+Workload deepDecorators()
+{
+    auto text = Text("deep decorator chain");
+    BaseElement e = text;
+    for (int i = 0; i < 100; ++i) {
+        e = Limit(1000, 1000)(ForegroundColor(static_cast<Color>(i % 16))(Bold(e)));
+    }
+    int counter = 0;
+    return RenderBench(120, 40, e, [text, counter](HeadlessTerminal &) mutable {
+        text->setText("deep decorator chain " + std::to_string(counter++ % 10));
+    });
+}
+
+Workload wideHContainer()
+{
+    std::vector<BaseElement> elements;
+    for (int i = 0; i < 200; ++i) {
+        elements.push_back(Text(std::to_string(i % 10)) | HStretch());
+    }
+    return RenderBench(200, 10, HContainer(elements), nullptr);
+}
+
+Workload wideVContainer()
+{
+    std::vector<BaseElement> elements;
+    for (int i = 0; i < 1000; ++i) {
+        elements.push_back(Text("row " + std::to_string(i)));
+    }
+    return RenderBench(120, 40, VContainer(elements), nullptr);
+}
+
+Workload nestedGrid()
+{
+    std::vector<BaseElement> rows;
+    for (int r = 0; r < 20; ++r) {
+        std::vector<BaseElement> columns;
+        for (int c = 0; c < 20; ++c) {
+            columns.push_back(Button(std::to_string(r * 20 + c), [] {}) | HStretch());
+        }
+        rows.push_back(HContainer(columns));
+    }
+    bool right = true;
+    return RenderBench(200, 40, VContainer(rows), [right](HeadlessTerminal &t) mutable {
+        right = !right;
+        t.sendKey(right ? ansi::KeyEvent::RIGHT : ansi::KeyEvent::LEFT);
+    });
+}
+
+Workload vmenuScroll(ansi::KeyEvent key)
+{
+    auto menu =
+        VMenu(100000, [](std::size_t i) { return BaseElement(Selectable(Text("process " + std::to_string(i)))); });
+    return RenderBench(120, 40, menu, [key](HeadlessTerminal &t) {
+        if (!t.sendKey(key)) {
+            t.sendKey(ansi::KeyEvent::HOME);
+        }
+    });
+}
+
+Workload vmenuVectorScroll()
+{
+    std::vector<BaseElement> rows;
+    for (int i = 0; i < 100000; ++i) {
+        rows.push_back(Selectable(Text("process " + std::to_string(i))));
+    }
+    return RenderBench(120, 40, VMenu(rows),
+                       [](HeadlessTerminal &t) { t.sendKey(ansi::KeyEvent::DOWN); });
+}
+
+Workload frameTextFill()
+{
+    auto text = Text("filled", true);
+    bool toggle = false;
+    return RenderBench(300, 100, Frame(text | Fit), [text, toggle](HeadlessTerminal &) mutable {
+        toggle = !toggle;
+        text->setText(toggle ? "filled" : "FILLED");
+    });
+}
+
+// A log receiving a burst of lines before every frame
+Workload logTail()
+{
+    auto log = LogView(10000);
+    std::size_t next = 0;
+    return RenderBench(120, 40, log, [log, next](HeadlessTerminal &) mutable {
+        for (int i = 0; i < 1000; ++i) {
+            log->append("event " + std::to_string(next++));
+        }
+    });
+}
+
+// Walks down a table of a million rows
+Workload tableScroll()
+{
+    using Column = detail::Table::Column;
+    std::vector<Column> columns{{"id", Column::Mode::Fixed, 8},
+                                {"name", Column::Mode::Auto},
+                                {"state", Column::Mode::Auto, 10},
+                                {"detail", Column::Mode::Stretch, 20}};
+    auto table = Table(columns, 1000000, [](std::size_t row, std::size_t column) {
+        switch (column) {
+            case 0:
+                return std::to_string(row);
+            case 1:
+                return "worker-" + std::to_string(row % 997);
+            case 2:
+                return std::string(row % 3 ? "running" : "idle");
+            default:
+                return "last seen " + std::to_string(row * 7 % 86400) + "s ago";
+        }
+    });
+    return RenderBench(120, 40, table, [](HeadlessTerminal &t) { t.sendKey(ansi::KeyEvent::DOWN); });
+}
+
+// A 4x3 grid of independent table panels, each scrolled every frame, rendered one after another or on the shared pool
+Workload dashboard(bool parallel)
+{
+    using Column = detail::Table::Column;
+    std::vector<BaseElement> tables;
+    std::vector<BaseElement> rows;
+    for (int row = 0; row < 3; ++row) {
+        std::vector<BaseElement> panels;
+        for (int column = 0; column < 4; ++column) {
+            auto table = Table({{"key"}, {"value", Column::Mode::Stretch}}, 100000, [](std::size_t row, std::size_t) {
+                return "sample " + std::to_string(row * 2654435761u % 1000000);
+            });
+            table->setFocus(true);
+            tables.push_back(table);
+            panels.push_back(Stretch()(Frame(Stretch()(table))));
+        }
+        BaseElement panelRow = parallel ? BaseElement(ParallelHContainer(panels)) : BaseElement(HContainer(panels));
+        rows.push_back(Stretch()(panelRow));
+    }
+    auto root = parallel ? BaseElement(ParallelVContainer(rows)) : BaseElement(VContainer(rows));
+    return RenderBench(240, 72, root, [tables](HeadlessTerminal &) {
+        for (auto &table : tables) {
+            table->handleEvent(ansi::KeyEvent::DOWN);
+        }
+    });
+}
+
+// A screen that is rebuilt from scratch on every refresh, optionally allocated from an arena
+Workload rebuild(bool useArena)
+{
+    auto arena = std::make_shared<Arena>();
+    auto terminal = std::make_shared<HeadlessTerminal>(120, 40);
+    auto out = std::make_shared<OutputBuffer>(-1);
+    return [=]() {
+        std::size_t bytes;
+        {
+            std::optional<Arena::Scope> scope;
+            if (useArena) {
+                scope.emplace(*arena);
+            }
+            std::vector<BaseElement> rows;
+            rows.reserve(500);
+            for (int i = 0; i < 500; ++i) {
+                rows.push_back(
+                    Bold(HContainer(Text("name") | HStretch(), ForegroundColor(Color::Green)(Text("value")))));
+            }
+            terminal->render(VContainer(rows));
+            bytes = terminal->encodeFrame(*out);
+            out->discard();
+        }
+        arena->reset();
+        return bytes;
+    };
+}
+
+// Rows with a chain of layers piped onto them, rebuilt every frame
+Workload decoratedRows()
+{
+    auto terminal = std::make_shared<HeadlessTerminal>(120, 40);
+    auto out = std::make_shared<OutputBuffer>(-1);
+    return [=]() {
+        std::vector<BaseElement> rows;
+        rows.reserve(500);
+        for (int i = 0; i < 500; ++i) {
+            rows.push_back(Text("decorated row") | Bold | ForegroundColor(static_cast<Color>(i % 16)) | Underline |
+                           HStretch() | Limit(100, 1));
+        }
+        terminal->render(VContainer(rows));
+        auto bytes = terminal->encodeFrame(*out);
+        out->discard();
+        return bytes;
+    };
+}
+
+Workload sgrEncoding()
+{
+    std::vector<Style> styles;
+    for (int i = 0; i < 64; ++i) {
+        Style style;
+        style.set(Style::Bold, i & 1);
+        style.set(Style::Underline, i & 2);
+        style.set(Style::Invert, i & 4);
+        if (i & 16) {
+            style.setForeground(TermColor::rgb(i * 4, 255 - i * 4, 128));
+        } else {
+            style.setForeground(static_cast<Color>(i % 16));
+        }
+        if (i & 8) {
+            style.setBackground(TermColor::palette(i * 3));
+        }
+        styles.push_back(style);
+    }
+    return [styles, encoder = SgrEncoder{}, out = std::make_shared<OutputBuffer>(-1)]() mutable {
+        for (int i = 0; i < 1000; ++i) {
+            encoder.encode(styles[(i * 7) % styles.size()], *out);
+        }
+        auto bytes = out->size();
+        out->discard();
+        return bytes;
+    };
+}
+
+Workload inputParsing()
+{
+    std::string stream;
+    for (int i = 0; i < 200; ++i) {
+        stream += "\033[A\033[B\033[1;5C\033OPabc\033[6~\033[24~x\x7f\r";
+    }
+    return [stream, parser = InputParser{}, events = std::vector<InputEvent>{}]() mutable {
+        events.clear();
+        parser.feed(stream, events);
+        return std::size_t{};
+    };
+}
+
+struct Benchmark {
+    std::string_view name;
+    std::function<Workload()> create;
+    std::size_t frames;
+};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string_view filter = argc > 1 ? argv[1] : "";
+    std::vector<Benchmark> benchmarks{
+        {"deep_decorators", deepDecorators, 2000},
+        {"wide_hcontainer", wideHContainer, 2000},
+        {"wide_vcontainer", wideVContainer, 2000},
+        {"nested_grid", nestedGrid, 2000},
+        {"vmenu_100k_down", [] { return vmenuScroll(ansi::KeyEvent::DOWN); }, 20000},
+        {"vmenu_100k_page_down", [] { return vmenuScroll(ansi::KeyEvent::PAGE_DOWN); }, 20000},
+        {"vmenu_vector_100k_down", vmenuVectorScroll, 20000},
+        {"table_1m_down", tableScroll, 20000},
+        {"dashboard_sequential", [] { return dashboard(false); }, 1000},
+        {"dashboard_parallel", [] { return dashboard(true); }, 1000},
+        {"frame_text_fill", frameTextFill, 1000},
+        {"logview_1000_lines", logTail, 1000},
+        {"rebuild_heap", [] { return rebuild(false); }, 1000},
+        {"rebuild_arena", [] { return rebuild(true); }, 1000},
+        {"decorated_rows", decoratedRows, 1000},
+        {"sgr_encode_1000", sgrEncoding, 10000},
+        {"input_parse", inputParsing, 10000},
+    };
+
+    std::printf("[\n");
+    bool first = true;
+    for (const auto &benchmark : benchmarks) {
+        if (benchmark.name.find(filter) == std::string_view::npos) {
+            continue;
+        }
+        auto frame = benchmark.create();
+        auto result = measure(frame, benchmark.frames);
+        // Only known when the library counts allocations
+        char allocations[32] = "null";
+        if (debug::countsAllocations) {
+            std::snprintf(allocations, sizeof(allocations), "%.2f", result.allocationsPerFrame);
+        }
+        std::printf("%s  {\"name\": \"%.*s\", \"frames\": %zu, \"ns_per_frame\": %.1f, \"bytes_per_frame\": %.1f, "
+                    "\"allocations_per_frame\": %s}",
+                    first ? "" : ",\n", static_cast<int>(benchmark.name.size()), benchmark.name.data(), result.frames,
+                    result.nsPerFrame, result.bytesPerFrame, allocations);
+        first = false;
+    }
+    std::printf("\n]\n");
+}
@@ -0,0 +1,39 @@
+// Only linked into executables that count allocations, never part of the library, see tuilight/debug.h
+#include "tuilight/debug.h"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+void *allocate(std::size_t size, std::size_t alignment)
+{
+    wibens::tuilight::debug::detail::allocationCount.fetch_add(1, std::memory_order_relaxed);
+    size = size == 0 ? 1 : size;
+    void *p = alignment <= alignof(std::max_align_t)
+                  ? std::malloc(size)
+                  : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+} // namespace
+
+void *operator new(std::size_t size) { return allocate(size, alignof(std::max_align_t)); }
+void *operator new[](std::size_t size) { return allocate(size, alignof(std::max_align_t)); }
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
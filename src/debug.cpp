@@ -0,0 +1,10 @@
+#include "tuilight/debug.h"
+
+namespace wibens::tuilight::debug
+{
+
+std::atomic<std::size_t> detail::allocationCount{0};
+
+std::size_t allocations() { return detail::allocationCount.load(std::memory_order_relaxed); }
+
+} // namespace wibens::tuilight::debug
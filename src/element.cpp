@@ -1,4 +1,6 @@
 #include "tuilight/element.h"
+#include <cstdio>
+#include <utility>
 
 namespace wibens::tuilight::detail
 {
@@ -10,28 +12,15 @@ void Center::render(View &view)
     inner->render(sv);
 }
 
-void ForegroundColor::render(View &view)
-{
-    view.viewStyle.fgColor = color;
-    inner->render(view);
-}
-
-void BackgroundColor::render(View &view)
-{
-    view.viewStyle.bgColor = color;
-    inner->render(view);
-}
-
 void Text::render(View &view)
 {
-    view.write(0, 0, view.viewStyle, text);
+    view.write(0, 0, view.viewStyle, content);
     if (fill) {
-        if (text.size() < view.width) {
-            view.write(text.size(), 0, view.viewStyle, std::string(view.width - text.size(), ' '));
+        if (columns < view.width) {
+            view.repeat(columns, 0, view.viewStyle, U' ', view.width - columns);
         }
-        std::string empty(view.width, ' ');
-        for (std::size_t i = 1; i < view.height; ++i) {
-            view.write(0, i, view.viewStyle, empty);
+        if (view.height > 1) {
+            view.fill(0, 1, view.width, view.height - 1, view.viewStyle);
         }
     }
 }
@@ -39,7 +28,7 @@ void Text::render(View &view)
 void Button::render(View &view)
 {
     if (isFocused()) {
-        view.viewStyle.invert = !view.viewStyle.invert;
+        view.viewStyle.toggle(Style::Invert);
         Text::render(view);
     } else {
         Text::render(view);
@@ -59,15 +48,74 @@ bool Button::handleEvent(ansi::KeyEvent event)
 
 VContainer::VContainer(const std::vector<BaseElement> &elements) : elements(elements)
 {
-    std::for_each(elements.cbegin(), elements.cend(), [this](const BaseElement &e) {
-        if (e->focusable()) {
-            this->focusableChildren.push_back(e);
+    focusIndex.resize(elements.size());
+    for (std::size_t i = 0; i < elements.size(); ++i) {
+        adopt(elements[i]);
+        focusIndex.set(i, elements[i]->focusable());
+    }
+    focusedElement = focusable() ? focusIndex.next(0) : 0;
+}
+
+VContainer::~VContainer()
+{
+    for (auto &element : elements) {
+        release(element);
+    }
+}
+
+void VContainer::insert(std::size_t index, BaseElement element)
+{
+    bool hadFocusable = focusable();
+    adopt(element);
+    focusIndex.insert(index, element->focusable());
+    elements.insert(elements.begin() + static_cast<long>(index), std::move(element));
+    if (!hadFocusable) {
+        focusedElement = focusable() ? index : 0;
+        if (focusable() && isFocused()) {
+            focusedChild()->setFocus(true);
         }
-    });
+    } else if (index <= focusedElement) {
+        ++focusedElement;
+    }
+    invalidate();
+    if (focusable() != hadFocusable) {
+        focusabilityChanged();
+    }
 }
 
-void VContainer::render(View &view)
+void VContainer::remove(std::size_t index)
+{
+    bool hadFocusable = focusable();
+    bool wasFocused = hadFocusable && index == focusedElement;
+    if (wasFocused) {
+        elements[index]->setFocus(false);
+    }
+    auto element = std::move(elements[index]);
+    elements.erase(elements.begin() + static_cast<long>(index));
+    // The same element may be a child more than once
+    if (std::ranges::find(elements, element) == elements.end()) {
+        release(element);
+    }
+    focusIndex.erase(index);
+    if (index < focusedElement) {
+        --focusedElement;
+    } else if (wasFocused) {
+        // The focus stays in place, on whatever comes next
+        auto next = focusIndex.next(index);
+        focusedElement = next != FocusIndex::none ? next : focusable() ? focusIndex.prev(index) : 0;
+        if (focusable() && isFocused()) {
+            focusedChild()->setFocus(true);
+        }
+    }
+    invalidate();
+    if (focusable() != hadFocusable) {
+        focusabilityChanged();
+    }
+}
+
+void VContainer::place(const View &view)
 {
+    placements.clear();
     std::size_t offset{};
     std::size_t slack{};
     auto size = getSize();
@@ -82,21 +130,184 @@ void VContainer::render(View &view)
             height += extraHeight;
             slack -= extraHeight;
         }
-        // height = std::min<std::size_t>(height, view.height - offset);
-        SubView subview{view, 0, offset, view.width, height};
-        element->render(subview);
+        placements.push_back({0, offset, view.width, height});
         offset += height;
     }
 }
 
+void VContainer::render(View &view)
+{
+    place(view);
+    for (std::size_t i = 0; i < elements.size(); ++i) {
+        auto [x, y, width, height] = placements[i];
+        SubView subview{view, x, y, width, height};
+        elements[i]->render(subview);
+    }
+}
+
+template <class Container> void Parallel<Container>::render(View &view)
+{
+    auto count = this->children().size();
+    if (pool.size() == 1 || pool.inRun() || count < minChildren || view.width * view.height < minCells) {
+        // Would run serially anyway or not be worth the handoff, the panels would only add a copy of every child
+        Container::render(view);
+        return;
+    }
+    this->place(view);
+    panels.resize(count);
+    pool.run(count, [&](std::size_t i) {
+        auto [x, y, width, height] = this->placements[i];
+        if (panels[i].width != width || panels[i].height != height) {
+            panels[i].resize(width, height);
+        } else {
+            panels[i].clear();
+        }
+        ScreenView panel(panels[i], view.viewStyle);
+        this->children()[i]->render(panel);
+    });
+    for (std::size_t i = 0; i < count; ++i) {
+        view.blit(this->placements[i].x, this->placements[i].y, panels[i], panels[i].width, panels[i].height);
+    }
+}
+
+template struct Parallel<VContainer>;
+template struct Parallel<HContainer>;
+
 void VContainer::focusChild(std::size_t index)
 {
-    focusableChildren[focusedElement]->setFocus(false);
+    elements[focusedElement]->setFocus(false);
     focusedElement = index;
-    focusableChildren[focusedElement]->setFocus(true);
+    elements[focusedElement]->setFocus(true);
+}
+
+void VContainer::focusFirst()
+{
+    if (focusable()) {
+        focusChild(focusIndex.next(0));
+    }
 }
 
-ElementSize VContainer::getSize() const
+void VContainer::focusLast()
+{
+    if (focusable()) {
+        focusChild(focusIndex.prev(elements.size()));
+    }
+}
+
+namespace
+{
+// How far position is from the cells first up to first + extent
+std::size_t distance(std::size_t position, std::size_t first, std::size_t extent)
+{
+    if (position < first) {
+        return first - position;
+    }
+    return position < first + extent ? 0 : position - (first + extent) + 1;
+}
+
+// The focusable child closest to position along the direction the children are laid out in. The child that covers it
+// is found by binary search, then its nearest focusable neighbours on either side are compared.
+template <class Placements>
+std::size_t nearest(const Placements &placements, const FocusIndex &focusIndex, std::size_t position,
+                    std::size_t Placements::value_type::*first, std::size_t Placements::value_type::*extent)
+{
+    auto it = std::upper_bound(placements.begin(), placements.end(), position,
+                               [first](std::size_t p, const auto &placement) { return p < placement.*first; });
+    auto covering = static_cast<std::size_t>(std::max<long>(it - placements.begin() - 1, 0));
+    auto after = focusIndex.next(covering);
+    auto before = focusIndex.prev(covering);
+    if (after == FocusIndex::none || before == FocusIndex::none) {
+        return after == FocusIndex::none ? before : after;
+    }
+    auto span = [&](std::size_t i) { return distance(position, placements[i].*first, placements[i].*extent); };
+    return span(before) < span(after) ? before : after;
+}
+} // namespace
+
+std::size_t VContainer::nearestFocusable(std::size_t /*column*/, std::size_t row) const
+{
+    return nearest(placements, focusIndex, row, &Placement::y, &Placement::height);
+}
+
+std::size_t HContainer::nearestFocusable(std::size_t column, std::size_t /*row*/) const
+{
+    return nearest(placements, focusableChildren(), column, &Placement::x, &Placement::width);
+}
+
+void VContainer::focusNear(std::size_t column, std::size_t row)
+{
+    if (!focusable()) {
+        return;
+    }
+    if (placements.size() != elements.size()) {
+        // Not drawn since the children changed
+        setFocus(true);
+        return;
+    }
+    elements[focusedElement]->setFocus(false);
+    focusedElement = nearestFocusable(column, row);
+    auto [x, y, width, height] = placements[focusedElement];
+    elements[focusedElement]->focusNear(column > x ? column - x : 0, row > y ? row - y : 0);
+    BaseElementImpl::setFocus(true);
+}
+
+std::pair<std::size_t, std::size_t> VContainer::focusPosition() const
+{
+    if (!focusable() || placements.size() != elements.size()) {
+        return {0, 0};
+    }
+    auto [column, row] = elements[focusedElement]->focusPosition();
+    return {placements[focusedElement].x + column, placements[focusedElement].y + row};
+}
+
+bool VContainer::moveFocus(bool forward, bool spatial)
+{
+    auto [column, row] = focusPosition();
+    elements[focusedElement]->setFocus(false);
+    auto index = forward ? focusIndex.next(focusedElement + 1) : focusIndex.prev(focusedElement);
+    // Children can stop being focusable, e.g. containers that lost theirs
+    while (index != FocusIndex::none && !elements[index]->focusable()) {
+        focusIndex.set(index, false);
+        index = forward ? focusIndex.next(index + 1) : focusIndex.prev(index);
+    }
+    if (index == FocusIndex::none) {
+        return false;
+    }
+    focusedElement = index;
+    if (spatial && placements.size() == elements.size()) {
+        auto [x, y, width, height] = placements[index];
+        elements[index]->focusNear(column > x ? column - x : 0, row > y ? row - y : 0);
+    } else {
+        elements[index]->setFocus(true);
+    }
+    return true;
+}
+
+void VContainer::childFocusabilityChanged(const BaseElementImpl &child)
+{
+    bool hadFocusable = focusable();
+    for (std::size_t i = 0; i < elements.size(); ++i) {
+        if (elements[i].get() == &child) {
+            focusIndex.set(i, child.focusable());
+        }
+    }
+    if (hadFocusable && !focusIndex.focusable(focusedElement)) {
+        elements[focusedElement]->setFocus(false);
+    }
+    if (focusable() && (!hadFocusable || !focusIndex.focusable(focusedElement))) {
+        // Like remove(), the focus goes to whatever comes next
+        auto next = focusIndex.next(focusedElement);
+        focusedElement = next != FocusIndex::none ? next : focusIndex.prev(focusedElement);
+        if (isFocused()) {
+            focusedChild()->setFocus(true);
+        }
+    }
+    if (focusable() != hadFocusable) {
+        focusabilityChanged();
+    }
+}
+
+ElementSize VContainer::computeSize() const
 {
     ElementSize size{};
     for (auto &element : elements) {
@@ -115,39 +326,37 @@ ElementSize VContainer::getSize() const
 
 bool VContainer::handleEvent(ansi::KeyEvent event)
 {
-    if (focusableChildren[focusedElement]->handleEvent(event)) {
+    if (!focusable()) {
+        return false;
+    }
+    if (focusedChild()->handleEvent(event)) {
         return true;
     }
     switch (event) {
         case ansi::KeyEvent::UP:
+            return moveFocus(false, true);
         case ansi::KeyEvent::BACKTAB:
-            focusableChildren[focusedElement]->setFocus(false);
-            if (focusedElement > 0) {
-                focusChild(focusedElement - 1);
-                return true;
-            }
-            break;
+            return moveFocus(false, false);
         case ansi::KeyEvent::DOWN:
+            return moveFocus(true, true);
         case ansi::KeyEvent::TAB:
-            focusableChildren[focusedElement]->setFocus(false);
-            if (focusedElement < focusableChildren.size() - 1) {
-                focusChild(focusedElement + 1);
-                return true;
-            }
+            return moveFocus(true, false);
+        default:
             break;
     }
     return false;
 }
 
-void HContainer::render(View &view)
+void HContainer::place(const View &view)
 {
+    placements.clear();
     std::size_t offset{};
     std::size_t slack{};
     auto size = getSize();
     if (view.width > size.minWidth) {
         slack = view.width - size.minWidth;
     }
-    for (auto &element : elements) {
+    for (auto &element : children()) {
         auto elemSize = element->getSize();
         std::size_t width = elemSize.minWidth;
         if (elemSize.maxWidth > width && slack > 0) {
@@ -155,16 +364,15 @@ void HContainer::render(View &view)
             width += extraWidth;
             slack -= extraWidth;
         }
-        SubView subview{view, offset, 0, width, view.height};
-        element->render(subview);
+        placements.push_back({offset, 0, width, view.height});
         offset += width;
     }
 }
 
-ElementSize HContainer::getSize() const
+ElementSize HContainer::computeSize() const
 {
     ElementSize size{};
-    for (auto &element : elements) {
+    for (auto &element : children()) {
         auto elemSize = element->getSize();
         size.minHeight = std::max(size.minHeight, elemSize.minHeight);
         size.minWidth += elemSize.minWidth;
@@ -180,27 +388,22 @@ ElementSize HContainer::getSize() const
 
 bool HContainer::handleEvent(ansi::KeyEvent event)
 {
-    if (focusableChildren[focusedElement]->handleEvent(event)) {
+    if (!focusable()) {
+        return false;
+    }
+    if (focusedChild()->handleEvent(event)) {
         return true;
     }
     switch (event) {
         case ansi::KeyEvent::LEFT:
+            return moveFocus(false, true);
         case ansi::KeyEvent::BACKTAB:
-            focusableChildren[focusedElement]->setFocus(false);
-            if (focusedElement > 0) {
-                --focusedElement;
-                focusableChildren[focusedElement]->setFocus(true);
-                return true;
-            }
-            break;
+            return moveFocus(false, false);
         case ansi::KeyEvent::RIGHT:
+            return moveFocus(true, true);
         case ansi::KeyEvent::TAB:
-            focusableChildren[focusedElement]->setFocus(false);
-            if (focusedElement < focusableChildren.size() - 1) {
-                ++focusedElement;
-                focusableChildren[focusedElement]->setFocus(true);
-                return true;
-            }
+            return moveFocus(true, false);
+        default:
             break;
     }
     return false;
@@ -213,96 +416,267 @@ void Bottom::render(View &view)
     inner->render(subview);
 }
 
-ElementSize Stretch::getSize() const
+void Frame::render(View &view)
+{
+    for (auto row : {std::size_t{0}, view.height - 1}) {
+        view.write(0, row, view.viewStyle, "#");
+        view.repeat(1, row, view.viewStyle, U'-', view.width - 2);
+        view.write(view.width - 1, row, view.viewStyle, "#");
+    }
+    for (std::size_t i = 1; i < view.height - 1; i++) {
+        view.write(0, i, view.viewStyle, "|");
+        view.write(view.width - 1, i, view.viewStyle, "|");
+    }
+    SubView sv(view, 1, 1, view.width - 2, view.height - 2);
+    inner->render(sv);
+}
+ElementSize Frame::computeSize() const
 {
     auto size = inner->getSize();
-    size.maxWidth = std::max<std::size_t>(size.maxWidth, maxWidth);
-    size.maxHeight = std::max<std::size_t>(size.maxHeight, maxHeight);
+    size.minWidth = size.minWidth + 2;
+    size.minHeight = size.minHeight + 2;
+    size.maxWidth = std::max(size.maxWidth, size.maxWidth + 2);
+    size.maxHeight = std::max(size.maxHeight, size.maxHeight + 2);
     return size;
 };
 
-ElementSize Shrink::getSize() const
+void Selectable::render(View &view)
 {
-    auto size = inner->getSize();
-    size.minWidth = std::min<std::size_t>(size.maxWidth, minWidth);
-    size.minHeight = std::min<std::size_t>(size.maxHeight, minHeight);
-    return size;
-};
+    if (isFocused()) {
+        view.viewStyle.toggle(Style::Invert);
+    }
+    inner->render(view);
+}
 
-void Limit::render(View &view)
+VMenu::VMenu(const std::vector<BaseElement> &elements)
+    : elements(elements), builder([this](std::size_t index) { return this->elements[index]; }), virtualRows(false),
+      rowCount(elements.size())
 {
-    if (view.width > maxWidth || view.height > maxHeight) {
-        SubView sv(view, 0, 0, std::min(maxWidth, view.width), std::min(maxHeight, view.height));
-        inner->render(sv);
-    } else {
-        inner->render(view);
+    heights.resize(rowCount);
+    focusIndex.resize(rowCount);
+    for (std::size_t i = 0; i < rowCount; ++i) {
+        adopt(elements[i]);
+        measure(i, elements[i]);
+    }
+    if (rowCount > 0) {
+        focusedIndex = focusable() ? focusIndex.next(0) : 0;
+        focusedRow = elements[focusedIndex];
     }
 }
 
-ElementSize Limit::getSize() const
+VMenu::VMenu(std::size_t count, RowBuilder builder, std::size_t rowHeight)
+    : builder(std::move(builder)), virtualRows(true), rowCount(count), heights(rowHeight)
 {
-    auto size = inner->getSize();
-    size.minWidth = std::min(size.minWidth, maxWidth);
-    size.minHeight = std::min(size.minHeight, maxHeight);
-    size.maxWidth = std::min(size.maxWidth, maxWidth);
-    size.maxHeight = std::min(size.maxHeight, maxHeight);
-    return size;
-};
+    heights.resize(rowCount);
+    focusIndex.resize(rowCount);
+}
 
-void Styler::render(View &view)
+VMenu::~VMenu()
 {
-    modifier(view.viewStyle);
-    inner->render(view);
+    for (auto &element : elements) {
+        release(element);
+    }
+    for (auto &[index, element] : rows) {
+        release(element);
+    }
+    if (focusedRow) {
+        release(focusedRow);
+    }
 }
 
-void Frame::render(View &view)
+bool VMenu::isCached(std::size_t index) const
 {
-    std::string horizontal = "#" + std::string(view.width - 2, '-') + "#";
-    view.write(0, 0, view.viewStyle, horizontal);
-    view.write(0, view.height - 1, view.viewStyle, horizontal);
-    for (std::size_t i = 1; i < view.height - 1; i++) {
-        view.write(0, i, view.viewStyle, "|");
-        view.write(view.width - 1, i, view.viewStyle, "|");
+    auto it =
+        std::lower_bound(rows.begin(), rows.end(), index, [](const Row &r, std::size_t i) { return r.first < i; });
+    return it != rows.end() && it->first == index;
+}
+
+BaseElement VMenu::row(std::size_t index)
+{
+    if (index == focusedIndex && focusedRow) {
+        return focusedRow;
     }
-    SubView sv(view, 1, 1, view.width - 2, view.height - 2);
-    inner->render(sv);
+    auto it =
+        std::lower_bound(rows.begin(), rows.end(), index, [](const Row &r, std::size_t i) { return r.first < i; });
+    if (it != rows.end() && it->first == index) {
+        return it->second;
+    }
+    auto element = builder(index);
+    measure(index, element);
+    return element;
 }
-ElementSize Frame::getSize() const
+
+void VMenu::measure(std::size_t index, const BaseElement &element)
 {
-    auto size = inner->getSize();
-    size.minWidth = size.minWidth + 2;
-    size.minHeight = size.minHeight + 2;
-    size.maxWidth = std::max(size.maxWidth, size.maxWidth + 2);
-    size.maxHeight = std::max(size.maxHeight, size.maxHeight + 2);
-    return size;
-};
+    auto size = element->getSize();
+    heights.set(index, size.minHeight);
+    focusIndex.set(index, element->focusable());
+    minWidth = std::max(minWidth, size.minWidth);
+    maxWidth = std::max(maxWidth, size.maxWidth);
+    stretchable = stretchable || size.maxHeight > size.minHeight;
+}
 
-void Selectable::render(View &view)
+void VMenu::drop(const BaseElement &element)
 {
-    if (isFocused()) {
-        Invert(inner)->render(view);
-    } else {
-        return inner->render(view);
+    if (virtualRows && element != focusedRow) {
+        release(element);
+    }
+}
+
+BaseElement VMenu::focusedChild()
+{
+    if (!focusedRow) {
+        focusedRow = row(focusedIndex);
+        if (!focusedRow->focusable()) {
+            // Virtual rows are only known once built, like the eager constructor the focus goes to the nearest one that
+            // turns out to be focusable
+            auto found = findFocusable(focusedIndex, true);
+            if (!found.second) {
+                found = findFocusable(focusedIndex, false);
+            }
+            if (found.second) {
+                focusedIndex = found.first;
+                focusedRow = std::move(found.second);
+            }
+        }
+        if (virtualRows) {
+            adopt(focusedRow);
+        }
+    }
+    return focusedRow;
+}
+
+void VMenu::focusRow(std::size_t index, BaseElement element)
+{
+    auto previousIndex = focusedIndex;
+    auto previous = focusedChild();
+    previous->setFocus(false);
+    focusedIndex = index;
+    focusedRow = std::move(element);
+    if (!isCached(previousIndex)) {
+        drop(previous);
+    }
+    if (focusedRow && virtualRows) {
+        adopt(focusedRow);
+    }
+    focusedChild()->setFocus(true);
+}
+
+void VMenu::setRowCount(std::size_t count)
+{
+    bool hadFocusable = focusable();
+    rowCount = count;
+    heights.resize(count);
+    focusIndex.resize(count);
+    while (!rows.empty() && rows.back().first >= count) {
+        drop(rows.back().second);
+        rows.pop_back();
+    }
+    if (focusedIndex >= count) {
+        if (focusedRow) {
+            focusedRow->setFocus(false);
+            drop(std::exchange(focusedRow, nullptr));
+        }
+        focusedIndex = count > 0 ? count - 1 : 0;
+    }
+    invalidate();
+    if (focusable() != hadFocusable) {
+        focusabilityChanged();
+    }
+}
+
+void VMenu::invalidateRow(std::size_t index)
+{
+    bool hadFocusable = focusable();
+    // Known again once the row is built
+    focusIndex.set(index, true);
+    auto it =
+        std::lower_bound(rows.begin(), rows.end(), index, [](const Row &r, std::size_t i) { return r.first < i; });
+    if (it != rows.end() && it->first == index) {
+        drop(it->second);
+        rows.erase(it);
+    }
+    if (index == focusedIndex && focusedRow) {
+        auto focus = focusedRow->isFocused();
+        drop(std::exchange(focusedRow, nullptr));
+        focusedChild()->setFocus(focus);
+    }
+    invalidate();
+    if (focusable() != hadFocusable) {
+        focusabilityChanged();
+    }
+}
+
+void VMenu::childFocusabilityChanged(const BaseElementImpl &child)
+{
+    bool hadFocusable = focusable();
+    if (focusedRow.get() == &child) {
+        focusIndex.set(focusedIndex, child.focusable());
+    }
+    for (auto &[index, element] : rows) {
+        if (element.get() == &child) {
+            focusIndex.set(index, child.focusable());
+        }
+    }
+    if (!virtualRows) {
+        for (std::size_t i = 0; i < elements.size(); ++i) {
+            if (elements[i].get() == &child) {
+                focusIndex.set(i, child.focusable());
+            }
+        }
+    }
+    if (focusable() && (!hadFocusable || !focusIndex.focusable(focusedIndex))) {
+        auto found = findFocusable(focusedIndex, true);
+        if (!found.second) {
+            found = findFocusable(focusedIndex, false);
+        }
+        if (found.second && found.first != focusedIndex) {
+            focusRow(found.first, std::move(found.second));
+            if (!isFocused()) {
+                focusedChild()->setFocus(false);
+            }
+        } else if (isFocused()) {
+            focusedChild()->setFocus(true);
+        }
+    }
+    if (focusable() != hadFocusable) {
+        focusabilityChanged();
     }
 }
 
 void VMenu::render(View &view)
 {
-    pageSize = view.height;
-    auto size = getSize();
+    pageSize = std::max<std::size_t>(view.height, 1);
+    if (rowCount == 0) {
+        return;
+    }
+    auto total = heights.total();
     std::size_t slack{};
-    if (size.minHeight > view.height) {
-        scrolledValue = std::min(scrolledValue, size.minHeight - view.height);
-        auto minScroll = offsets[focusedIndex + 1] - static_cast<long>(view.height);
-        auto maxScroll = offsets[focusedIndex];
-        scrolledValue = std::clamp<long>(scrolledValue, minScroll, maxScroll);
+    if (total > view.height) {
+        auto top = heights.offset(focusedIndex);
+        auto bottom = heights.offset(focusedIndex + 1);
+        scrolledValue = std::min(scrolledValue, total - view.height);
+        if (bottom > scrolledValue + view.height) {
+            scrolledValue = bottom - view.height;
+        }
+        scrolledValue = std::min(scrolledValue, top);
     } else {
         scrolledValue = 0;
-        slack = view.height - size.minHeight;
+        slack = view.height - total;
     }
 
-    auto offset = -scrolledValue;
-    for (auto &element : elements) {
+    nextRows.clear();
+    auto index = heights.find(scrolledValue);
+    auto offset = static_cast<long>(heights.offset(index)) - static_cast<long>(scrolledValue);
+    bool remeasured = false;
+    for (; index < rowCount && offset < static_cast<long>(view.height); ++index) {
+        auto element = row(index);
+        auto before = heights.height(index);
+        measure(index, element);
+        remeasured = remeasured || before != heights.height(index);
+        if (virtualRows) {
+            adopt(element);
+        }
         auto elemSize = element->getSize();
         std::size_t height = elemSize.minHeight;
         if (elemSize.maxHeight > height && slack > 0) {
@@ -310,70 +684,97 @@ void VMenu::render(View &view)
             height += extraHeight;
             slack -= extraHeight;
         }
-        // height = std::min<std::size_t>(height, view.height - offset);
-        SubView subview{view, 0, offset, view.width, height};
+        SubView subview{view, 0, static_cast<std::size_t>(offset), view.width, height};
         element->render(subview);
-        offset += height;
+        nextRows.emplace_back(index, std::move(element));
+        offset += static_cast<long>(height);
+    }
+    for (auto &[oldIndex, element] : rows) {
+        if (!std::binary_search(nextRows.begin(), nextRows.end(), Row{oldIndex, nullptr},
+                                [](const Row &a, const Row &b) { return a.first < b.first; })) {
+            drop(element);
+        }
+    }
+    rows.swap(nextRows);
+    if (remeasured) {
+        // Rows that were estimated with the default height turned out differently, fix the layout next frame
+        invalidate();
     }
 }
 
-ElementSize VMenu::getSize() const
+ElementSize VMenu::computeSize() const
 {
-    ElementSize size{};
-    offsets.clear();
-    for (auto &element : elements) {
-        offsets.push_back(size.minHeight);
-        auto elemSize = element->getSize();
-        size.minWidth = std::max(size.minWidth, elemSize.minWidth);
-        size.minHeight += elemSize.minHeight;
-        size.maxWidth = std::max(size.maxWidth, elemSize.maxWidth);
-        size.maxHeight += elemSize.maxHeight;
-        if (size.maxHeight < elemSize.maxHeight) {
-            // overflow
-            size.maxHeight = std::numeric_limits<std::size_t>::max();
+    auto total = heights.total();
+    return {minWidth, total, maxWidth, stretchable ? std::numeric_limits<std::size_t>::max() : total};
+}
+
+VMenu::Row VMenu::findFocusable(std::size_t index, bool forward)
+{
+    index = forward ? focusIndex.next(index) : focusIndex.prev(index);
+    while (index != FocusIndex::none) {
+        auto element = row(index);
+        if (element->focusable()) {
+            return {index, std::move(element)};
         }
+        focusIndex.set(index, false);
+        index = forward ? focusIndex.next(index + 1) : focusIndex.prev(index);
     }
-    offsets.push_back(size.minHeight);
-    return size;
+    return {FocusIndex::none, nullptr};
 }
 
 bool VMenu::next()
 {
-    std::size_t newFocus = focusedIndex;
-    elements[newFocus]->setFocus(false);
-    while (newFocus < elements.size() - 1) {
-        newFocus++;
-        if (elements[newFocus]->focusable()) {
-            focusedIndex = newFocus;
-            elements[newFocus]->setFocus(true);
-            return true;
-        }
+    if (auto [index, element] = findFocusable(focusedIndex + 1, true); element) {
+        focusRow(index, std::move(element));
+        return true;
     }
+    focusedChild()->setFocus(false);
     return false;
 }
 bool VMenu::prev()
 {
-    std::size_t newFocus = focusedIndex;
-    elements[newFocus]->setFocus(false);
-    while (newFocus > 0) {
-        newFocus--;
-        if (elements[newFocus]->focusable()) {
-            focusedIndex = newFocus;
-            elements[newFocus]->setFocus(true);
-            return true;
-        }
+    if (auto [index, element] = findFocusable(focusedIndex, false); element) {
+        focusRow(index, std::move(element));
+        return true;
     }
+    focusedChild()->setFocus(false);
     return false;
 }
+
+void VMenu::focusNear(std::size_t /*column*/, std::size_t row)
+{
+    if (rowCount == 0) {
+        return;
+    }
+    auto target = heights.find(scrolledValue + row);
+    auto after = findFocusable(target, true);
+    auto before = findFocusable(target, false);
+    auto &found = !after.second || (before.second && target - before.first < after.first - target) ? before : after;
+    if (found.second && found.first != focusedIndex) {
+        focusRow(found.first, std::move(found.second));
+    } else {
+        focusedChild()->setFocus(true);
+    }
+    BaseElementImpl::setFocus(true);
+}
+
+std::pair<std::size_t, std::size_t> VMenu::focusPosition() const
+{
+    auto top = heights.offset(focusedIndex);
+    return {0, top > scrolledValue ? top - scrolledValue : 0};
+}
 bool VMenu::handleEvent(ansi::KeyEvent event)
 {
-    if (elements[focusedIndex]->handleEvent(event)) {
+    if (rowCount == 0) {
+        return false;
+    }
+    if (focusedChild()->handleEvent(event)) {
         return true;
     }
     switch (event) {
         case ansi::KeyEvent::TAB:
         case ansi::KeyEvent::BACKTAB:
-            elements[focusedIndex]->setFocus(false);
+            focusedChild()->setFocus(false);
             return false;
         case ansi::KeyEvent::UP:
             return prev();
@@ -381,41 +782,394 @@ bool VMenu::handleEvent(ansi::KeyEvent event)
             return next();
         case ansi::KeyEvent::PAGE_UP:
             if (focusedIndex > 0) {
-                elements[focusedIndex]->setFocus(false);
-                if (focusedIndex >= pageSize) {
-                    focusedIndex -= pageSize;
-                } else {
-                    focusedIndex = 0;
+                auto top = heights.offset(focusedIndex);
+                auto target = std::min(heights.find(top > pageSize ? top - pageSize : 0), focusedIndex - 1);
+                // The first focusable row from the target on, or the closest one above it
+                auto found = findFocusable(target, true);
+                if (!found.second || found.first >= focusedIndex) {
+                    found = findFocusable(target, false);
+                }
+                if (found.second) {
+                    focusRow(found.first, std::move(found.second));
                 }
-                elements[focusedIndex]->setFocus(true);
             }
             return true;
         case ansi::KeyEvent::PAGE_DOWN:
-            if (focusedIndex < elements.size() - 1) {
-                elements[focusedIndex]->setFocus(false);
-                focusedIndex = std::min(elements.size() - 1, focusedIndex + pageSize);
-                elements[focusedIndex]->setFocus(true);
+            if (focusedIndex < rowCount - 1) {
+                auto target = std::max(heights.find(heights.offset(focusedIndex) + pageSize), focusedIndex + 1);
+                // The last focusable row up to the target, or the closest one below it
+                auto found = findFocusable(target + 1, false);
+                if (!found.second || found.first <= focusedIndex) {
+                    found = findFocusable(target + 1, true);
+                }
+                if (found.second) {
+                    focusRow(found.first, std::move(found.second));
+                }
             }
             return true;
-            break;
         case ansi::KeyEvent::HOME:
-            if (focusedIndex > 0) {
-                elements[focusedIndex]->setFocus(false);
-                focusedIndex = 0;
-                elements[focusedIndex]->setFocus(true);
-            }
-            break;
         case ansi::KeyEvent::END:
-            if (focusedIndex < elements.size() - 1) {
-                elements[focusedIndex]->setFocus(false);
-                focusedIndex = elements.size() - 1;
-                elements[focusedIndex]->setFocus(true);
+            if (auto [index, element] = findFocusable(event == ansi::KeyEvent::HOME ? 0 : rowCount,
+                                                      event == ansi::KeyEvent::HOME);
+                element && index != focusedIndex) {
+                focusRow(index, std::move(element));
+                return true;
             }
             break;
+        default:
+            break;
     }
     return false;
 }
 
+LogView::LogView(std::size_t capacity, Notify notify) : lines(std::max<std::size_t>(capacity, 1)), notify(notify) {}
+
+void LogView::append(std::string line)
+{
+    bool first;
+    {
+        std::lock_guard lock(mutex);
+        first = pending.empty();
+        pending.push_back(std::move(line));
+    }
+    if (first && notify) {
+        notify();
+    }
+}
+
+void LogView::clear()
+{
+    firstLine += count;
+    head = 0;
+    count = 0;
+}
+
+void LogView::takePending()
+{
+    {
+        std::lock_guard lock(mutex);
+        // Swapping hands the producers the cleared vector of the previous frame, so neither side reallocates
+        std::swap(pending, batch);
+    }
+    // Lines that would be pushed out by the same batch are never stored
+    auto skipped = batch.size() > lines.size() ? batch.size() - lines.size() : 0;
+    if (skipped > 0) {
+        clear();
+        firstLine += skipped;
+    }
+    for (auto line = batch.begin() + skipped; line != batch.end(); ++line) {
+        push(std::move(*line));
+    }
+    batch.clear();
+}
+
+void LogView::push(std::string &&line)
+{
+    if (count < lines.size()) {
+        lines[(head + count++) % lines.size()] = std::move(line);
+    } else {
+        lines[head] = std::move(line);
+        head = (head + 1) % lines.size();
+        ++firstLine;
+    }
+}
+
+void LogView::render(View &view)
+{
+    takePending();
+    pageSize = std::max<std::size_t>(view.height, 1);
+    top = follow ? lastTop() : std::clamp(top, firstLine, lastTop());
+    for (std::size_t row = 0; row < view.height && top + row < firstLine + count; ++row) {
+        view.write(0, row, view.viewStyle, lines[(head + top + row - firstLine) % lines.size()]);
+    }
+}
+
+bool LogView::scroll(long delta)
+{
+    auto previousTop = follow ? lastTop() : std::clamp(top, firstLine, lastTop());
+    auto wasFollowing = follow;
+    auto target = static_cast<long>(previousTop) + delta;
+    top = static_cast<std::size_t>(std::clamp(target, static_cast<long>(firstLine), static_cast<long>(lastTop())));
+    follow = top >= lastTop();
+    return top != previousTop || follow != wasFollowing;
+}
+
+bool LogView::handleEvent(ansi::KeyEvent event)
+{
+    // Scrolling past either end is left to the parent, so the focus can move on
+    switch (event) {
+        case ansi::KeyEvent::UP:
+            return scroll(-1);
+        case ansi::KeyEvent::DOWN:
+            return scroll(1);
+        case ansi::KeyEvent::PAGE_UP:
+            return scroll(-static_cast<long>(pageSize));
+        case ansi::KeyEvent::PAGE_DOWN:
+            return scroll(static_cast<long>(pageSize));
+        case ansi::KeyEvent::HOME:
+            top = firstLine;
+            follow = count <= pageSize;
+            return true;
+        case ansi::KeyEvent::END:
+            follow = true;
+            return true;
+        default:
+            return false;
+    }
+}
+
+Table::Table(std::vector<Column> columns, std::size_t rowCount, CellProvider provider)
+    : columns(std::move(columns)), rowCount(rowCount), provider(std::move(provider))
+{
+    measure();
+}
+
+void Table::measure()
+{
+    widths.assign(columns.size(), 0);
+    auto step = std::max<std::size_t>(rowCount / sampledRows, 1);
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        auto &column = columns[i];
+        auto width = unicode::displayWidth(column.title);
+        if (column.mode == Column::Mode::Fixed) {
+            width = column.width;
+        } else if (column.mode == Column::Mode::Stretch) {
+            width = std::max(width, column.width);
+        } else {
+            for (std::size_t row = 0; row < rowCount; row += step) {
+                width = std::max(width, unicode::displayWidth(provider(row, i)));
+            }
+            if (column.width > 0) {
+                width = std::min(width, column.width);
+            }
+        }
+        widths[i] = width;
+    }
+    invalidate();
+}
+
+void Table::setRowCount(std::size_t count)
+{
+    bool hadRows = rowCount > 0;
+    rowCount = count;
+    selected = std::min(selected, count > 0 ? count - 1 : 0);
+    measure();
+    if (hadRows != (count > 0)) {
+        focusabilityChanged();
+    }
+}
+
+void Table::selectRow(std::size_t row)
+{
+    if (row < rowCount) {
+        selected = row;
+    }
+}
+
+ElementSize Table::computeSize() const
+{
+    std::size_t width{};
+    bool stretchable = false;
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        width += widths[i] + (i > 0 ? columnGap : 0);
+        stretchable = stretchable || columns[i].mode == Column::Mode::Stretch;
+    }
+    auto height = rowCount + 1;
+    return {width, std::min<std::size_t>(height, 2), stretchable ? std::numeric_limits<std::size_t>::max() : width,
+            height};
+}
+
+void Table::place(std::size_t width)
+{
+    std::size_t natural{};
+    std::size_t stretchColumns{};
+    for (std::size_t i = firstColumn; i < columns.size(); ++i) {
+        natural += widths[i] + (i > firstColumn ? columnGap : 0);
+        stretchColumns += columns[i].mode == Column::Mode::Stretch;
+    }
+    auto slack = width > natural ? width - natural : 0;
+
+    visible.clear();
+    std::size_t x{};
+    for (auto i = firstColumn; i < columns.size() && x < width; ++i) {
+        auto columnWidth = widths[i];
+        if (columns[i].mode == Column::Mode::Stretch && stretchColumns > 0) {
+            auto extra = slack / stretchColumns--;
+            columnWidth += extra;
+            slack -= extra;
+        }
+        visible.push_back({i, x, std::min(columnWidth, width - x)});
+        x += columnWidth + columnGap;
+    }
+    clipped = !visible.empty() && (visible.back().column + 1 < columns.size() ||
+                                   visible.back().width < widths[visible.back().column]);
+}
+
+void Table::render(View &view)
+{
+    if (view.height == 0) {
+        return;
+    }
+    place(view.width);
+    pageSize = std::max<std::size_t>(view.height - 1, 1);
+    auto header = view.viewStyle;
+    header.set(Style::Bold);
+    for (auto [column, x, width] : visible) {
+        SubView cell(view, x, 0, width, 1);
+        cell.write(0, 0, header, columns[column].title);
+    }
+
+    if (selected < scrolledRow) {
+        scrolledRow = selected;
+    } else if (selected >= scrolledRow + pageSize) {
+        scrolledRow = selected - pageSize + 1;
+    }
+    scrolledRow = std::min(scrolledRow, rowCount > pageSize ? rowCount - pageSize : 0);
+    for (std::size_t row = 1; row < view.height && scrolledRow + row - 1 < rowCount; ++row) {
+        auto index = scrolledRow + row - 1;
+        auto style = view.viewStyle;
+        if (isFocused() && index == selected) {
+            // The selection bar spans the gaps between the columns as well
+            style.toggle(Style::Invert);
+            view.repeat(0, row, style, U' ', view.width);
+        }
+        for (auto [column, x, width] : visible) {
+            SubView cell(view, x, row, width, 1);
+            cell.write(0, 0, style, provider(index, column));
+        }
+    }
+}
+
+bool Table::handleEvent(ansi::KeyEvent event)
+{
+    // Without rows only the columns can scroll
+    if (rowCount == 0 && event != ansi::KeyEvent::LEFT && event != ansi::KeyEvent::RIGHT) {
+        return false;
+    }
+    switch (event) {
+        case ansi::KeyEvent::UP:
+            if (selected == 0) {
+                return false;
+            }
+            --selected;
+            return true;
+        case ansi::KeyEvent::DOWN:
+            if (selected + 1 >= rowCount) {
+                return false;
+            }
+            ++selected;
+            return true;
+        case ansi::KeyEvent::PAGE_UP:
+            selected -= std::min(selected, pageSize);
+            return true;
+        case ansi::KeyEvent::PAGE_DOWN:
+            selected = std::min(selected + pageSize, rowCount - 1);
+            return true;
+        case ansi::KeyEvent::HOME:
+            selected = 0;
+            return true;
+        case ansi::KeyEvent::END:
+            selected = rowCount - 1;
+            return true;
+        case ansi::KeyEvent::LEFT:
+            if (firstColumn == 0) {
+                return false;
+            }
+            --firstColumn;
+            return true;
+        case ansi::KeyEvent::RIGHT:
+            if (!clipped || firstColumn + 1 >= columns.size()) {
+                return false;
+            }
+            ++firstColumn;
+            return true;
+        default:
+            return false;
+    }
+}
+
+void Profile::render(View &view)
+{
+    auto &profiler = Profiler::instance();
+    if (!profiler.enabled()) {
+        inner->render(view);
+        return;
+    }
+    auto start = Profiler::Clock::now();
+    inner->render(view);
+    profiler.record(node, Profiler::Phase::Render, start, Profiler::Clock::now());
+}
+
+ElementSize Profile::computeSize() const
+{
+    auto &profiler = Profiler::instance();
+    if (!profiler.enabled()) {
+        return inner->getSize();
+    }
+    auto start = Profiler::Clock::now();
+    auto size = inner->getSize();
+    profiler.record(node, Profiler::Phase::Layout, start, Profiler::Clock::now());
+    return size;
+}
+
+void StatsOverlay::render(View &view)
+{
+    inner->render(view);
+    if (!shown) {
+        return;
+    }
+    auto &profiler = Profiler::instance();
+    auto frame = profiler.lastFrame();
+    profiler.nodes(nodes);
+    std::sort(nodes.begin(), nodes.end(), [](const auto &a, const auto &b) { return a.render.time > b.render.time; });
+    nodes.resize(std::min(nodes.size(), maxTags));
+
+    constexpr std::size_t boxWidth = 40;
+    auto x = view.width > boxWidth ? view.width - boxWidth : 0;
+    SubView box(view, x, 0, boxWidth, 7 + (nodes.empty() ? 0 : nodes.size() + 1));
+    auto style = view.viewStyle;
+    style.toggle(Style::Invert);
+    box.fill(0, 0, box.width, box.height, style);
+
+    auto ms = [](std::chrono::nanoseconds time) { return std::chrono::duration<double, std::milli>(time).count(); };
+    char line[boxWidth + 1];
+    std::size_t row = 0;
+    auto print = [&](auto... args) {
+        std::snprintf(line, sizeof(line), args...);
+        box.write(1, row++, style, line);
+    };
+    print("frame    %8.2f ms", ms(frame.layout + frame.render + frame.output));
+    print("layout   %8.2f ms", ms(frame.layout));
+    print("render   %8.2f ms", ms(frame.render));
+    print("output   %8.2f ms", ms(frame.output));
+    print("bytes    %8zu", frame.bytes);
+    print("cells    %8zu", frame.cellsChanged);
+    print("syscalls %8zu", frame.syscalls);
+    if (!nodes.empty()) {
+        print("%-16s %5s %7s %7s", "tag", "calls", "layout", "render");
+        for (const auto &node : nodes) {
+            print("%-16.16s %5zu %7.2f %7.2f", node.tag.c_str(), node.render.calls, ms(node.layout.time),
+                  ms(node.render.time));
+        }
+    }
+}
+
+bool StatsOverlay::handleEvent(ansi::KeyEvent event)
+{
+    if (event != toggle) {
+        return inner->handleEvent(event);
+    }
+    auto &profiler = Profiler::instance();
+    shown = !shown;
+    if (shown) {
+        wasEnabled = profiler.enabled();
+        profiler.setEnabled(true);
+    } else {
+        profiler.setEnabled(wasEnabled);
+    }
+    return true;
+}
+
 bool NoEscape::handleEvent(ansi::KeyEvent event)
 {
     if (!inner->handleEvent(event)) {
@@ -0,0 +1,102 @@
+#include "tuilight/encoder.h"
+#include "tuilight/ansi.h"
+
+namespace wibens::tuilight
+{
+
+void FrameEncoder::encode(const Screen &next, OutputBuffer &out)
+{
+    if (front.width != next.width || front.height != next.height) {
+        front.resize(next.width, next.height);
+        clear(out);
+    }
+    scroll(next, out);
+    for (std::size_t row = 0; row < next.height; ++row) {
+        if (next.rowHash(row) == front.rowHash(row)) {
+            continue;
+        }
+        runs.clear();
+        diffRow(next, front, row, mergeGap, runs);
+        for (auto [begin, end] : runs) {
+            if (next.glyph(begin, row) == Cell::continuation && begin > 0) {
+                // The wide character before it has to be written again to cover this column
+                --begin;
+            }
+            ansi::moveCursor(out, begin, row);
+            auto style = next.style(begin, row);
+            sgr.encode(style, out);
+            for (auto column = begin; column < end; ++column) {
+                auto c = next.glyph(column, row);
+                if (c == Cell::continuation) {
+                    continue;
+                }
+                if (next.style(column, row) != style) {
+                    style = next.style(column, row);
+                    sgr.encode(style, out);
+                }
+                out.appendCodepoint(c);
+                ++totalCells;
+            }
+        }
+        front.copyRow(next, row);
+    }
+}
+
+void FrameEncoder::scroll(const Screen &next, OutputBuffer &out)
+{
+    struct Shift {
+        std::size_t top;
+        std::size_t bottom;
+        int lines;
+        std::size_t saved;
+    } best{};
+
+    auto height = next.height;
+    std::size_t changed = 0;
+    for (std::size_t row = 0; row < height; ++row) {
+        changed += next.rowHash(row) != front.rowHash(row);
+    }
+    if (changed < minScrolledRows) {
+        return;
+    }
+    for (std::size_t distance = 1; distance <= height / 2; ++distance) {
+        for (int direction : {1, -1}) {
+            // Row r of the next frame shows displayed row r + distance when scrolling up, r - distance when down
+            std::size_t first = direction > 0 ? 0 : distance;
+            std::size_t last = direction > 0 ? height - distance : height;
+            std::size_t start = first;
+            std::size_t saved = 0;
+            for (auto row = first; row <= last; ++row) {
+                auto source = direction > 0 ? row + distance : row - distance;
+                if (row < last && next.rowHash(row) == front.rowHash(source)) {
+                    saved += next.rowHash(row) != front.rowHash(row);
+                    continue;
+                }
+                if (saved > best.saved) {
+                    best = {direction > 0 ? start : start - distance, direction > 0 ? row + distance : row,
+                            direction * static_cast<int>(distance), saved};
+                }
+                start = row + 1;
+                saved = 0;
+            }
+        }
+    }
+    if (best.saved < minScrolledRows) {
+        return;
+    }
+    // The rows scrolled in are blanked with the current background color
+    sgr.encode(Style{}, out);
+    ansi::setScrollRegion(out, best.top, best.bottom);
+    ansi::scroll(out, best.lines);
+    ansi::resetScrollRegion(out);
+    front.scroll(best.top, best.bottom, best.lines);
+}
+
+void FrameEncoder::clear(OutputBuffer &out)
+{
+    sgr.encode(Style{}, out);
+    ansi::clear(out);
+    front.clear();
+}
+
+} // namespace wibens::tuilight
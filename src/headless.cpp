@@ -0,0 +1,102 @@
+#include "tuilight/headless.h"
+#include "tuilight/unicode.h"
+
+namespace wibens::tuilight
+{
+
+HeadlessTerminal::HeadlessTerminal(std::size_t width, std::size_t height) : View(width, height), cells(width, height)
+{
+}
+
+void HeadlessTerminal::resize(std::size_t newWidth, std::size_t newHeight)
+{
+    width = newWidth;
+    height = newHeight;
+    cells.resize(width, height);
+}
+
+void HeadlessTerminal::setRoot(BaseElement e)
+{
+    root = NoEscape(e);
+    // Also when nothing can take the focus yet, so whatever becomes focusable later gets it
+    root->setFocus(true);
+}
+
+void HeadlessTerminal::render() { render(root); }
+
+void HeadlessTerminal::render(BaseElement e)
+{
+    debug::AllocationCounter counter;
+    FrameProfile profile;
+    if (e && profile) {
+        e->getSize();
+        profile.lap(&FrameStats::layout, "layout");
+    }
+    cells.clear();
+    if (e) {
+        e->render(*this);
+    }
+    profile.lap(&FrameStats::render, "render");
+    profile.finish();
+    allocations = counter.count();
+}
+
+bool HeadlessTerminal::sendKey(KeyEvent event) { return root && root->handleEvent(event); }
+
+bool HeadlessTerminal::sendPaste(std::string_view text) { return root && root->handlePaste(text); }
+
+bool HeadlessTerminal::sendInput(std::string_view data)
+{
+    events.clear();
+    parser.feed(data, events);
+    parser.timeout(events);
+    bool handled = false;
+    for (const auto &event : events) {
+        if (event.key == KeyEvent::PASTE) {
+            handled = sendPaste(event.text) || handled;
+        } else if (event.key > KeyEvent::UNKNOWN) {
+            handled = sendKey(event.key) || handled;
+        }
+    }
+    return handled;
+}
+
+void HeadlessTerminal::write(std::size_t column, std::size_t row, Style style, std::string_view data)
+{
+    cells.write(column, row, style, data);
+}
+
+void HeadlessTerminal::blit(std::size_t column, std::size_t row, const Screen &source, std::size_t width,
+                            std::size_t height)
+{
+    cells.blit(column, row, source, width, height);
+}
+
+void HeadlessTerminal::fill(std::size_t column, std::size_t row, std::size_t width, std::size_t height, Style style,
+                            char32_t c)
+{
+    cells.fill(column, row, width, height, style, c);
+}
+
+std::size_t HeadlessTerminal::encodeFrame(OutputBuffer &out)
+{
+    auto before = out.size();
+    encoder.encode(cells, out);
+    return out.size() - before;
+}
+
+std::string HeadlessTerminal::rowText(std::size_t row) const
+{
+    std::string text;
+    text.reserve(cells.width);
+    for (std::size_t column = 0; column < cells.width; ++column) {
+        auto c = cells.glyph(column, row);
+        if (c != Cell::continuation) {
+            char bytes[4];
+            text.append(bytes, unicode::encode(c, bytes));
+        }
+    }
+    return text;
+}
+
+} // namespace wibens::tuilight
@@ -0,0 +1,198 @@
+#include "tuilight/index.h"
+#include <algorithm>
+#include <bit>
+
+namespace wibens::tuilight
+{
+
+namespace
+{
+std::size_t lowBit(std::size_t i) { return i & (~i + 1); }
+} // namespace
+
+long long HeightIndex::deviation(std::size_t index) const
+{
+    long long sum{};
+    for (auto i = index; i > 0; i -= lowBit(i)) {
+        sum += tree[i];
+    }
+    return sum;
+}
+
+void HeightIndex::resize(std::size_t newCount)
+{
+    if (!tree.empty()) {
+        // Appended rows have no deviation, so each new node only covers the existing rows in its range
+        tree.resize(newCount + 1);
+        for (auto i = count + 1; i <= newCount; ++i) {
+            tree[i] = deviation(i - 1) - deviation(i - lowBit(i));
+        }
+    }
+    count = newCount;
+}
+
+void HeightIndex::set(std::size_t index, std::size_t newHeight)
+{
+    auto delta = static_cast<long long>(newHeight) - static_cast<long long>(height(index));
+    if (delta == 0) {
+        return;
+    }
+    if (tree.empty()) {
+        tree.assign(count + 1, 0);
+    }
+    for (auto i = index + 1; i <= count; i += lowBit(i)) {
+        tree[i] += delta;
+    }
+}
+
+std::size_t HeightIndex::offset(std::size_t index) const
+{
+    auto base = index * defaultHeight;
+    if (tree.empty()) {
+        return base;
+    }
+    return static_cast<std::size_t>(static_cast<long long>(base) + deviation(index));
+}
+
+std::size_t HeightIndex::find(std::size_t target) const
+{
+    if (count == 0) {
+        return 0;
+    }
+    if (tree.empty()) {
+        return defaultHeight == 0 ? 0 : std::min(target / defaultHeight, count - 1);
+    }
+    std::size_t position{};
+    for (auto step = std::bit_floor(count); step > 0; step >>= 1) {
+        auto next = position + step;
+        if (next <= count) {
+            auto block = static_cast<std::size_t>(static_cast<long long>(step * defaultHeight) + tree[next]);
+            if (block <= target) {
+                position = next;
+                target -= block;
+            }
+        }
+    }
+    return std::min(position, count - 1);
+}
+
+std::size_t FocusIndex::exceptions(std::size_t index) const
+{
+    std::size_t sum{};
+    for (auto i = index; i > 0; i -= lowBit(i)) {
+        sum += tree[i];
+    }
+    return sum;
+}
+
+void FocusIndex::rebuild()
+{
+    tree.assign(entries + 1, 0);
+    for (std::size_t i = 1; i <= entries; ++i) {
+        tree[i] += flipped[i - 1];
+        if (auto parent = i + lowBit(i); parent <= entries) {
+            tree[parent] += tree[i];
+        }
+    }
+}
+
+void FocusIndex::resize(std::size_t count)
+{
+    if (count < entries) {
+        focusableCount = rank(count);
+    } else if (defaultFocusable) {
+        focusableCount += count - entries;
+    }
+    if (!flipped.empty()) {
+        // Like HeightIndex::resize, appended entries are no exceptions
+        flipped.resize(count);
+        tree.resize(count + 1);
+        for (auto i = entries + 1; i <= count; ++i) {
+            tree[i] = exceptions(i - 1) - exceptions(i - lowBit(i));
+        }
+    }
+    entries = count;
+}
+
+void FocusIndex::insert(std::size_t index, bool focusable)
+{
+    ++entries;
+    focusableCount += focusable;
+    if (flipped.empty() && focusable == defaultFocusable) {
+        return;
+    }
+    if (flipped.empty()) {
+        flipped.assign(entries - 1, false);
+    }
+    flipped.insert(flipped.begin() + static_cast<long>(index), focusable != defaultFocusable);
+    rebuild();
+}
+
+void FocusIndex::erase(std::size_t index)
+{
+    focusableCount -= focusable(index);
+    --entries;
+    if (!flipped.empty()) {
+        flipped.erase(flipped.begin() + static_cast<long>(index));
+        rebuild();
+    }
+}
+
+void FocusIndex::set(std::size_t index, bool focusable)
+{
+    if (this->focusable(index) == focusable) {
+        return;
+    }
+    if (flipped.empty()) {
+        flipped.assign(entries, false);
+        tree.assign(entries + 1, 0);
+    }
+    flipped[index] = !flipped[index];
+    for (auto i = index + 1; i <= entries; i += lowBit(i)) {
+        flipped[index] ? ++tree[i] : --tree[i];
+    }
+    focusable ? ++focusableCount : --focusableCount;
+}
+
+std::size_t FocusIndex::rank(std::size_t index) const
+{
+    auto flips = flipped.empty() ? 0 : exceptions(index);
+    return defaultFocusable ? index - flips : flips;
+}
+
+std::size_t FocusIndex::select(std::size_t rank) const
+{
+    if (flipped.empty()) {
+        return rank;
+    }
+    // The longest prefix holding no more than rank focusable entries ends right before the one that is wanted
+    std::size_t position{};
+    for (auto step = std::bit_floor(entries); step > 0; step >>= 1) {
+        auto next = position + step;
+        if (next <= entries) {
+            auto block = defaultFocusable ? step - tree[next] : tree[next];
+            if (block <= rank) {
+                position = next;
+                rank -= block;
+            }
+        }
+    }
+    return position;
+}
+
+std::size_t FocusIndex::next(std::size_t from) const
+{
+    if (from >= entries) {
+        return none;
+    }
+    auto before = rank(from);
+    return before < focusableCount ? select(before) : none;
+}
+
+std::size_t FocusIndex::prev(std::size_t end) const
+{
+    auto before = rank(std::min(end, entries));
+    return before > 0 ? select(before - 1) : none;
+}
+
+} // namespace wibens::tuilight
@@ -0,0 +1,174 @@
+#include "tuilight/input.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+
+namespace wibens::tuilight
+{
+using ansi::KeyEvent;
+using ansi::KeyModifier;
+
+namespace
+{
+struct Sequence {
+    char final;
+    int number;
+    KeyEvent key;
+};
+
+// CSI <number> <final> and SS3 <final>, a number of 0 matches sequences without one
+constexpr std::array<Sequence, 31> sequences{{
+    {'A', 0, KeyEvent::UP},       {'B', 0, KeyEvent::DOWN},      {'C', 0, KeyEvent::RIGHT},
+    {'D', 0, KeyEvent::LEFT},     {'F', 0, KeyEvent::END},       {'H', 0, KeyEvent::HOME},
+    {'Z', 0, KeyEvent::BACKTAB},  {'P', 0, KeyEvent::F1},        {'Q', 0, KeyEvent::F2},
+    {'R', 0, KeyEvent::F3},       {'S', 0, KeyEvent::F4},        {'~', 1, KeyEvent::HOME},
+    {'~', 2, KeyEvent::INSERT},   {'~', 3, KeyEvent::DELETE},    {'~', 4, KeyEvent::END},
+    {'~', 5, KeyEvent::PAGE_UP},  {'~', 6, KeyEvent::PAGE_DOWN}, {'~', 7, KeyEvent::HOME},
+    {'~', 8, KeyEvent::END},      {'~', 11, KeyEvent::F1},       {'~', 12, KeyEvent::F2},
+    {'~', 13, KeyEvent::F3},      {'~', 14, KeyEvent::F4},       {'~', 15, KeyEvent::F5},
+    {'~', 17, KeyEvent::F6},      {'~', 18, KeyEvent::F7},       {'~', 19, KeyEvent::F8},
+    {'~', 20, KeyEvent::F9},      {'~', 21, KeyEvent::F10},      {'~', 23, KeyEvent::F11},
+    {'~', 24, KeyEvent::F12},
+}};
+
+constexpr char escape = 0x1b;
+constexpr std::string_view pasteEnd = "\033[201~";
+
+KeyEvent lookup(char final, int number)
+{
+    auto match = [&](const Sequence &s) { return s.final == final && s.number == number; };
+    auto it = std::find_if(sequences.begin(), sequences.end(), match);
+    return it != sequences.end() ? it->key : KeyEvent::UNKNOWN;
+}
+
+KeyEvent plainKey(char c)
+{
+    switch (c) {
+        case '\r':
+            return KeyEvent::RETURN;
+        case 0x7f:
+            return KeyEvent::BACKSPACE;
+        default:
+            return ansi::CharEvent(c);
+    }
+}
+
+// The xterm modifier parameter is 1 + a bitmask of shift, alt and ctrl
+KeyEvent applyModifiers(KeyEvent key, int parameter)
+{
+    if (parameter <= 1 || key == KeyEvent::UNKNOWN) {
+        return key;
+    }
+    auto mask = parameter - 1;
+    if (mask & 1) {
+        key = key | KeyModifier::SHIFT;
+    }
+    if (mask & 2) {
+        key = key | KeyModifier::ALT;
+    }
+    if (mask & 4) {
+        key = key | KeyModifier::CTRL;
+    }
+    return key;
+}
+} // namespace
+
+void InputParser::feed(std::string_view data, std::vector<InputEvent> &events)
+{
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        char c = data[i];
+        switch (state) {
+            case State::Ground:
+                if (c == escape) {
+                    state = State::Escape;
+                } else {
+                    events.push_back({plainKey(c)});
+                }
+                break;
+            case State::Escape:
+                if (c == '[') {
+                    parameters.clear();
+                    state = State::Csi;
+                } else if (c == 'O') {
+                    state = State::Ss3;
+                } else if (c == escape) {
+                    events.push_back({KeyEvent::ESCAPE});
+                } else {
+                    events.push_back({plainKey(c) | KeyModifier::ALT});
+                    state = State::Ground;
+                }
+                break;
+            case State::Csi:
+                if (c >= 0x40 && c <= 0x7e) {
+                    state = State::Ground;
+                    finishCsi(c, events);
+                } else {
+                    parameters.push_back(c);
+                }
+                break;
+            case State::Ss3:
+                events.push_back({lookup(c, 0)});
+                state = State::Ground;
+                break;
+            case State::Paste: {
+                // Everything up to the end marker is copied at once, the marker may be split across reads
+                auto rest = data.substr(i);
+                auto searchFrom = paste.size() > pasteEnd.size() ? paste.size() - pasteEnd.size() : 0;
+                paste.append(rest);
+                auto end = paste.find(pasteEnd, searchFrom);
+                if (end == std::string::npos) {
+                    i = data.size();
+                    break;
+                }
+                auto trailing = paste.size() - end - pasteEnd.size();
+                paste.resize(end);
+                events.push_back({KeyEvent::PASTE, std::move(paste)});
+                paste.clear();
+                state = State::Ground;
+                i += rest.size() - trailing - 1;
+                break;
+            }
+        }
+    }
+}
+
+void InputParser::finishCsi(char final, std::vector<InputEvent> &events)
+{
+    int number = 0;
+    int modifiers = 0;
+    auto separator = parameters.find(';');
+    std::string_view first = std::string_view(parameters).substr(0, separator);
+    std::from_chars(first.data(), first.data() + first.size(), number);
+    if (separator != std::string::npos) {
+        std::string_view second = std::string_view(parameters).substr(separator + 1);
+        std::from_chars(second.data(), second.data() + second.size(), modifiers);
+    }
+    if (final == '~' && number == 200) {
+        paste.clear();
+        state = State::Paste;
+        return;
+    }
+    // CSI 1;5A carries a number only to be able to pass the modifiers
+    if (final != '~' && number == 1) {
+        number = 0;
+    }
+    events.push_back({applyModifiers(lookup(final, number), modifiers)});
+}
+
+void InputParser::timeout(std::vector<InputEvent> &events)
+{
+    switch (state) {
+        case State::Escape:
+            events.push_back({KeyEvent::ESCAPE});
+            break;
+        case State::Csi:
+        case State::Ss3:
+            events.push_back({KeyEvent::UNKNOWN});
+            break;
+        default:
+            return;
+    }
+    state = State::Ground;
+}
+
+} // namespace wibens::tuilight
@@ -35,7 +35,7 @@ int main()
     auto b = Button("Quit", [&] { t.stop(); });
     auto both = VContainer(a | Fit | ForegroundColor(Color::Gray), b);
 
-    t.runInteractive(both | KeyHander(handle));
+    t.runInteractive(both | KeyHander(handle) | StatsOverlay());
     running = false;
     t.clear();
 }
@@ -0,0 +1,78 @@
+#include "tuilight/output.h"
+#include <array>
+#include <cerrno>
+#include <poll.h>
+#include <sys/uio.h>
+#include <system_error>
+
+namespace wibens::tuilight
+{
+
+namespace
+{
+constexpr std::string_view beginSynchronized = "\033[?2026h";
+constexpr std::string_view endSynchronized = "\033[?2026l";
+
+void waitWritable(int fd)
+{
+    struct pollfd pollFd {
+        fd, POLLOUT, 0
+    };
+    poll(&pollFd, 1, -1);
+}
+} // namespace
+
+OutputBuffer::OutputBuffer(int fd, std::size_t capacity) : outputFd(fd) { buffer.reserve(capacity); }
+
+void OutputBuffer::flush()
+{
+    if (buffer.empty()) {
+        return;
+    }
+    std::array<struct iovec, 3> parts{};
+    std::size_t count = 0;
+    auto add = [&](std::string_view data) {
+        parts[count].iov_base = const_cast<char *>(data.data());
+        parts[count].iov_len = data.size();
+        ++count;
+    };
+    if (synchronizedUpdate) {
+        add(beginSynchronized);
+    }
+    add(buffer);
+    if (synchronizedUpdate) {
+        add(endSynchronized);
+    }
+
+    // The tty may share its non-blocking flag with stdin, so partial writes and EAGAIN are expected
+    auto *part = parts.data();
+    while (count > 0) {
+        auto written = ::writev(outputFd, part, static_cast<int>(count));
+        ++totalWrites;
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                waitWritable(outputFd);
+                continue;
+            }
+            buffer.clear();
+            throw std::system_error(errno, std::generic_category(), "write failed");
+        }
+        totalBytes += written;
+        auto remaining = static_cast<std::size_t>(written);
+        while (count > 0 && remaining >= part->iov_len) {
+            remaining -= part->iov_len;
+            ++part;
+            --count;
+        }
+        if (count > 0) {
+            part->iov_base = static_cast<char *>(part->iov_base) + remaining;
+            part->iov_len -= remaining;
+        }
+    }
+    buffer.clear();
+}
+
+} // namespace wibens::tuilight
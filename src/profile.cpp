@@ -0,0 +1,211 @@
+#include "tuilight/profile.h"
+#include <cerrno>
+#include <cstdio>
+#include <system_error>
+
+namespace wibens::tuilight
+{
+
+namespace
+{
+unsigned threadNumber()
+{
+    static std::atomic<unsigned> next{1};
+    thread_local unsigned number = next.fetch_add(1, std::memory_order_relaxed);
+    return number;
+}
+
+Timing timing(std::uint64_t calls, std::uint64_t nanoseconds)
+{
+    return {static_cast<std::size_t>(calls), std::chrono::nanoseconds(nanoseconds)};
+}
+
+void writeJsonString(std::FILE *file, std::string_view text)
+{
+    std::fputc('"', file);
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            std::fputc('\\', file);
+            std::fputc(c, file);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            std::fprintf(file, "\\u%04x", c);
+        } else {
+            std::fputc(c, file);
+        }
+    }
+    std::fputc('"', file);
+}
+} // namespace
+
+Profiler::Profiler() : origin(Clock::now()) { frames.reserve(historySize); }
+
+Profiler &Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+void Profiler::reset()
+{
+    std::lock_guard lock(mutex);
+    for (auto &node : tags) {
+        for (std::size_t phase = 0; phase < node->calls.size(); ++phase) {
+            node->calls[phase] = 0;
+            node->nanoseconds[phase] = 0;
+        }
+        node->stats = NodeStats{};
+        node->stats.tag = node->tag;
+    }
+    frames.clear();
+    frameCount = 0;
+    events.clear();
+}
+
+FrameStats Profiler::lastFrame() const
+{
+    std::lock_guard lock(mutex);
+    return frameCount == 0 ? FrameStats{} : frames[(frameCount - 1) % historySize];
+}
+
+std::vector<FrameStats> Profiler::history() const
+{
+    std::lock_guard lock(mutex);
+    std::vector<FrameStats> result;
+    result.reserve(frames.size());
+    for (auto i = frameCount - frames.size(); i < frameCount; ++i) {
+        result.push_back(frames[i % historySize]);
+    }
+    return result;
+}
+
+void Profiler::nodes(std::vector<NodeStats> &out) const
+{
+    std::lock_guard lock(mutex);
+    out.resize(tags.size());
+    for (std::size_t i = 0; i < tags.size(); ++i) {
+        out[i] = tags[i]->stats;
+    }
+}
+
+std::vector<NodeStats> Profiler::nodes() const
+{
+    std::vector<NodeStats> result;
+    nodes(result);
+    return result;
+}
+
+Profiler::Node &Profiler::node(std::string_view tag)
+{
+    std::lock_guard lock(mutex);
+    for (auto &node : tags) {
+        if (node->tag == tag) {
+            return *node;
+        }
+    }
+    auto &node = *tags.emplace_back(std::make_unique<Node>(tag));
+    node.stats.tag = node.tag;
+    return node;
+}
+
+void Profiler::record(Node &node, Phase phase, Clock::time_point start, Clock::time_point end)
+{
+    auto index = static_cast<std::size_t>(phase);
+    node.calls[index].fetch_add(1, std::memory_order_relaxed);
+    node.nanoseconds[index].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+                                      std::memory_order_relaxed);
+    if (tracing()) {
+        trace(node.tag, phase == Phase::Layout ? "layout" : "render", start, end);
+    }
+}
+
+void Profiler::trace(std::string_view name, std::string_view category, Clock::time_point start, Clock::time_point end)
+{
+    auto thread = threadNumber();
+    std::lock_guard lock(mutex);
+    if (events.size() < maxTraceEvents) {
+        events.push_back({name, category, start, end - start, thread});
+    }
+}
+
+void Profiler::endFrame(const FrameStats &stats)
+{
+    std::lock_guard lock(mutex);
+    if (frames.size() < historySize) {
+        frames.push_back(stats);
+    } else {
+        frames[frameCount % historySize] = stats;
+    }
+    ++frameCount;
+
+    // The counters only ever grow, the last frame is the difference to the totals seen at the previous one
+    for (auto &node : tags) {
+        auto layout = timing(node->calls[0].load(std::memory_order_relaxed),
+                             node->nanoseconds[0].load(std::memory_order_relaxed));
+        auto render = timing(node->calls[1].load(std::memory_order_relaxed),
+                             node->nanoseconds[1].load(std::memory_order_relaxed));
+        auto &s = node->stats;
+        s.layout = {layout.calls - s.totalLayout.calls, layout.time - s.totalLayout.time};
+        s.render = {render.calls - s.totalRender.calls, render.time - s.totalRender.time};
+        s.totalLayout = layout;
+        s.totalRender = render;
+    }
+}
+
+void Profiler::writeChromeTrace(const std::string &path) const
+{
+    auto *file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+    }
+    std::lock_guard lock(mutex);
+    std::fputs("{\"traceEvents\": [\n", file);
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const auto &event = events[i];
+        using Microseconds = std::chrono::duration<double, std::micro>;
+        std::fputs("  {\"name\": ", file);
+        writeJsonString(file, event.name);
+        std::fprintf(file, ", \"cat\": \"%.*s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %u}",
+                     static_cast<int>(event.category.size()), event.category.data(),
+                     Microseconds(event.start - origin).count(), Microseconds(event.duration).count(), event.thread);
+        std::fputs(i + 1 < events.size() ? ",\n" : "\n", file);
+    }
+    std::fputs("]}\n", file);
+    if (std::fclose(file) != 0) {
+        throw std::system_error(errno, std::generic_category(), "cannot write " + path);
+    }
+}
+
+FrameProfile::FrameProfile() : active(Profiler::instance().enabled())
+{
+    if (active) {
+        frameStart = phaseStart = Profiler::Clock::now();
+    }
+}
+
+void FrameProfile::lap(std::chrono::nanoseconds FrameStats::*phase, std::string_view name)
+{
+    if (!active) {
+        return;
+    }
+    auto now = Profiler::Clock::now();
+    stats.*phase += now - phaseStart;
+    auto &profiler = Profiler::instance();
+    if (profiler.tracing()) {
+        profiler.trace(name, "frame", phaseStart, now);
+    }
+    phaseStart = now;
+}
+
+void FrameProfile::finish()
+{
+    if (!active) {
+        return;
+    }
+    auto &profiler = Profiler::instance();
+    if (profiler.tracing()) {
+        profiler.trace("frame", "frame", frameStart, Profiler::Clock::now());
+    }
+    profiler.endFrame(stats);
+}
+
+} // namespace wibens::tuilight
@@ -0,0 +1,267 @@
+#include "tuilight/screen.h"
+#include "tuilight/unicode.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace wibens::tuilight
+{
+
+namespace
+{
+std::uint64_t mix(std::uint64_t h, std::uint64_t value)
+{
+    h ^= value * 0x9E3779B97F4A7C15ULL;
+    h = (h << 27) | (h >> 37);
+    return h * 0xBF58476D1CE4E5B9ULL;
+}
+
+template <class T> std::uint64_t hashPlane(std::uint64_t h, const T *data, std::size_t count)
+{
+    const auto *bytes = reinterpret_cast<const unsigned char *>(data);
+    std::size_t size = count * sizeof(T);
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        h = mix(h, word);
+    }
+    if (i < size) {
+        std::uint64_t word{};
+        std::memcpy(&word, bytes + i, size - i);
+        h = mix(h, word);
+    }
+    return h;
+}
+} // namespace
+
+Screen::Screen(std::size_t width, std::size_t height) { resize(width, height); }
+
+void Screen::resize(std::size_t newWidth, std::size_t newHeight)
+{
+    width = newWidth;
+    height = newHeight;
+    glyphs.assign(width * height, U' ');
+    styles.assign(width * height, Style{});
+    blankHash = hashPlane(hashPlane(0, glyphs.data(), width), styles.data(), width);
+    hashes.assign(height, blankHash);
+    hashValid.assign(height, true);
+}
+
+void Screen::clear()
+{
+    std::fill(glyphs.begin(), glyphs.end(), U' ');
+    std::fill(styles.begin(), styles.end(), Style{});
+    std::fill(hashes.begin(), hashes.end(), blankHash);
+    std::fill(hashValid.begin(), hashValid.end(), true);
+}
+
+std::uint64_t Screen::rowHash(std::size_t row) const
+{
+    if (!hashValid[row]) {
+        hashes[row] = hashPlane(hashPlane(0, &glyphs[row * width], width), &styles[row * width], width);
+        hashValid[row] = true;
+    }
+    return hashes[row];
+}
+
+void Screen::copyRow(const Screen &other, std::size_t row)
+{
+    std::copy_n(&other.glyphs[row * width], width, &glyphs[row * width]);
+    std::copy_n(&other.styles[row * width], width, &styles[row * width]);
+    hashes[row] = other.hashes[row];
+    hashValid[row] = other.hashValid[row];
+}
+
+void Screen::blit(std::size_t column, std::size_t row, const Screen &source, std::size_t sourceWidth,
+                  std::size_t sourceHeight)
+{
+    if (column >= width || row >= height) {
+        return;
+    }
+    auto count = std::min({sourceWidth, source.width, width - column});
+    auto rows = std::min({sourceHeight, source.height, height - row});
+    for (std::size_t y = 0; y < rows; ++y) {
+        auto *line = &glyphs[(row + y) * width];
+        // Wide characters cut in half on either edge are blanked, like write() does
+        if (line[column] == Cell::continuation && column > 0) {
+            line[column - 1] = U' ';
+        }
+        std::copy_n(&source.glyphs[y * source.width], count, line + column);
+        std::copy_n(&source.styles[y * source.width], count, &styles[(row + y) * width + column]);
+        hashValid[row + y] = false;
+        auto end = column + count;
+        if (count < source.width && source.glyphs[y * source.width + count] == Cell::continuation) {
+            line[end - 1] = U' ';
+        }
+        if (end < width && line[end] == Cell::continuation) {
+            line[end] = U' ';
+        }
+    }
+}
+
+void Screen::scroll(std::size_t top, std::size_t bottom, int lines)
+{
+    auto count = std::min(static_cast<std::size_t>(lines > 0 ? lines : -lines), bottom - top);
+    auto kept = bottom - top - count;
+    if (lines > 0) {
+        std::copy_n(&glyphs[(top + count) * width], kept * width, &glyphs[top * width]);
+        std::copy_n(&styles[(top + count) * width], kept * width, &styles[top * width]);
+        std::copy_n(hashes.begin() + top + count, kept, hashes.begin() + top);
+        std::copy_n(hashValid.begin() + top + count, kept, hashValid.begin() + top);
+        blankRows(bottom - count, bottom);
+    } else {
+        std::copy_backward(&glyphs[top * width], &glyphs[(top + kept) * width], &glyphs[bottom * width]);
+        std::copy_backward(&styles[top * width], &styles[(top + kept) * width], &styles[bottom * width]);
+        std::copy_backward(hashes.begin() + top, hashes.begin() + top + kept, hashes.begin() + bottom);
+        std::copy_backward(hashValid.begin() + top, hashValid.begin() + top + kept, hashValid.begin() + bottom);
+        blankRows(top, top + count);
+    }
+}
+
+void Screen::blankRows(std::size_t first, std::size_t last)
+{
+    std::fill(&glyphs[first * width], &glyphs[last * width], U' ');
+    std::fill(&styles[first * width], &styles[last * width], Style{});
+    std::fill(hashes.begin() + first, hashes.begin() + last, blankHash);
+    std::fill(hashValid.begin() + first, hashValid.begin() + last, true);
+}
+
+void Screen::fill(std::size_t column, std::size_t row, std::size_t fillWidth, std::size_t fillHeight, Style style,
+                  char32_t c)
+{
+    auto cells = static_cast<std::size_t>(unicode::width(c));
+    if (column >= width || row >= height || cells == 0) {
+        return;
+    }
+    // Only whole characters are drawn
+    auto end = column + std::min(fillWidth, width - column) / cells * cells;
+    if (end == column) {
+        return;
+    }
+    for (auto y = row; y < std::min(row + fillHeight, height); ++y) {
+        auto *line = &glyphs[y * width];
+        if (line[column] == Cell::continuation && column > 0) {
+            line[column - 1] = U' ';
+        }
+        std::fill(&styles[y * width + column], &styles[y * width + end], style);
+        if (cells == 1) {
+            std::fill(line + column, line + end, c);
+        } else {
+            for (auto x = column; x < end; x += 2) {
+                line[x] = c;
+                line[x + 1] = Cell::continuation;
+            }
+        }
+        if (end < width && line[end] == Cell::continuation) {
+            line[end] = U' ';
+        }
+        hashValid[y] = false;
+    }
+}
+
+void Screen::write(std::size_t column, std::size_t row, Style style, std::string_view data)
+{
+    if (row >= height || column >= width) {
+        return;
+    }
+    hashValid[row] = false;
+    auto *line = &glyphs[row * width];
+    auto *lineStyles = &styles[row * width];
+    // Overwriting one half of a wide character blanks the other half
+    if (line[column] == Cell::continuation && column > 0) {
+        line[column - 1] = U' ';
+    }
+    std::size_t end = column;
+    if (unicode::isAscii(data)) {
+        auto count = std::min(data.size(), width - column);
+        std::copy_n(data.begin(), count, line + column);
+        std::fill_n(lineStyles + column, count, style);
+        end += count;
+    } else {
+        for (std::size_t pos = 0; pos < data.size() && end < width;) {
+            auto c = unicode::decode(data, pos);
+            auto columns = static_cast<std::size_t>(unicode::width(c));
+            // Combining characters have no cell of their own and are dropped
+            if (columns == 0) {
+                continue;
+            }
+            if (end + columns > width) {
+                break;
+            }
+            line[end] = c;
+            lineStyles[end] = style;
+            if (columns == 2) {
+                line[end + 1] = Cell::continuation;
+                lineStyles[end + 1] = style;
+            }
+            end += columns;
+        }
+    }
+    if (end < width && line[end] == Cell::continuation) {
+        line[end] = U' ';
+    }
+}
+
+void diffRow(const Screen &next, const Screen &shown, std::size_t row, std::size_t mergeGap, std::vector<Run> &runs)
+{
+    auto width = next.width;
+    const auto *glyphs = &next.glyphs[row * width];
+    const auto *shownGlyphs = &shown.glyphs[row * width];
+    const auto *styles = &next.styles[row * width];
+    const auto *shownStyles = &shown.styles[row * width];
+    auto mark = [&](std::size_t column) {
+        if (!runs.empty() && column <= runs.back().end + mergeGap) {
+            runs.back().end = column + 1;
+        } else {
+            runs.push_back({column, column + 1});
+        }
+    };
+    auto markMask = [&](std::size_t base, unsigned changed) {
+        while (changed != 0) {
+            mark(base + std::countr_zero(changed));
+            changed &= changed - 1;
+        }
+    };
+
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= width; i += 8) {
+        auto load = [](const void *p) { return _mm256_loadu_si256(static_cast<const __m256i *>(p)); };
+        auto stylesEqual = [&](std::size_t at) {
+            auto equal = _mm256_cmpeq_epi64(load(styles + at), load(shownStyles + at));
+            return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(equal)));
+        };
+        auto glyphsEqual = _mm256_cmpeq_epi32(load(glyphs + i), load(shownGlyphs + i));
+        auto equal = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(glyphsEqual))) &
+                     (stylesEqual(i) | stylesEqual(i + 4) << 4);
+        markMask(i, ~equal & 0xFFu);
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 4 <= width; i += 4) {
+        auto load = [](const void *p) { return _mm_loadu_si128(static_cast<const __m128i *>(p)); };
+        // SSE2 has no 64-bit compare, a style is equal when both of its 32-bit halves are
+        auto stylesEqual = [&](std::size_t at) {
+            auto halves = static_cast<unsigned>(
+                _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(load(styles + at), load(shownStyles + at)))));
+            auto pairs = halves & halves >> 1;
+            return (pairs & 1u) | (pairs >> 1 & 2u);
+        };
+        auto glyphsEqual = _mm_cmpeq_epi32(load(glyphs + i), load(shownGlyphs + i));
+        auto equal = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(glyphsEqual))) &
+                     (stylesEqual(i) | stylesEqual(i + 2) << 2);
+        markMask(i, ~equal & 0xFu);
+    }
+#endif
+    for (; i < width; ++i) {
+        if (glyphs[i] != shownGlyphs[i] || styles[i] != shownStyles[i]) {
+            mark(i);
+        }
+    }
+}
+
+} // namespace wibens::tuilight
@@ -0,0 +1,138 @@
+#include "tuilight/sgr.h"
+#include "tuilight/ansi.h"
+#include <array>
+#include <charconv>
+
+namespace wibens::tuilight
+{
+using namespace ansi;
+
+namespace
+{
+struct Params {
+    void add(unsigned code)
+    {
+        if (size > 0) {
+            data[size++] = ';';
+        }
+        auto result = std::to_chars(data.data() + size, data.data() + data.size(), code);
+        size = result.ptr - data.data();
+    }
+    void add(StyleCode code) { add(static_cast<unsigned>(code)); }
+
+    std::array<char, 64> data;
+    std::size_t size{};
+};
+
+unsigned colorCode(Color color)
+{
+    if (color >= Color::Gray) {
+        return static_cast<unsigned>(color) - static_cast<unsigned>(Color::Gray) +
+               static_cast<unsigned>(ColorCode::Gray);
+    }
+    return static_cast<unsigned>(color) + static_cast<unsigned>(ColorCode::Black);
+}
+
+// offset is 0 for the foreground and 10 for the background
+void addColor(Params &params, TermColor color, unsigned offset)
+{
+    switch (color.kind()) {
+        case TermColor::Kind::Default:
+            params.add(static_cast<unsigned>(ColorCode::Reset) + offset);
+            break;
+        case TermColor::Kind::Named:
+            params.add(colorCode(color.color()) + offset);
+            break;
+        case TermColor::Kind::Palette:
+            params.add(38 + offset);
+            params.add(5);
+            params.add(color.index());
+            break;
+        case TermColor::Kind::Rgb:
+            params.add(38 + offset);
+            params.add(2);
+            params.add(color.red());
+            params.add(color.green());
+            params.add(color.blue());
+            break;
+    }
+}
+
+void addAttributes(Params &params, const Style &style, const Style &previous)
+{
+    auto turnedOn = style.attributes() & ~previous.attributes();
+    if (turnedOn & Style::Bold) {
+        params.add(StyleCode::Bold);
+    }
+    if (turnedOn & Style::Dim) {
+        params.add(StyleCode::Dim);
+    }
+    if (turnedOn & Style::Underline) {
+        params.add(StyleCode::Underline);
+    }
+    if (turnedOn & Style::Blink) {
+        params.add(StyleCode::Blink);
+    }
+    if (turnedOn & Style::Invert) {
+        params.add(StyleCode::Invert);
+    }
+    if (turnedOn & Style::Hidden) {
+        params.add(StyleCode::Hidden);
+    }
+    if (style.foreground() != previous.foreground()) {
+        addColor(params, style.foreground(), 0);
+    }
+    if (style.background() != previous.background()) {
+        addColor(params, style.background(), 10);
+    }
+}
+
+void addDelta(Params &params, const Style &style, Style previous)
+{
+    auto turnedOff = previous.attributes() & ~style.attributes();
+    // Bold and dim share a single "normal intensity" code
+    if (turnedOff & (Style::Bold | Style::Dim)) {
+        params.add(22);
+        previous.set(Style::Bold, false);
+        previous.set(Style::Dim, false);
+    }
+    if (turnedOff & Style::Underline) {
+        params.add(24);
+    }
+    if (turnedOff & Style::Blink) {
+        params.add(25);
+    }
+    if (turnedOff & Style::Invert) {
+        params.add(27);
+    }
+    if (turnedOff & Style::Hidden) {
+        params.add(28);
+    }
+    addAttributes(params, style, previous);
+}
+} // namespace
+
+void SgrEncoder::encode(const Style &style, OutputBuffer &out)
+{
+    if (current == style) {
+        return;
+    }
+    Params full;
+    full.add(StyleCode::Reset);
+    addAttributes(full, style, Style{});
+
+    const Params *params = &full;
+    Params delta;
+    if (current.has_value()) {
+        addDelta(delta, style, *current);
+        if (delta.size <= full.size) {
+            params = &delta;
+        }
+    }
+    out.append("\033[");
+    out.append(std::string_view(params->data.data(), params->size));
+    out.append('m');
+    current = style;
+}
+
+} // namespace wibens::tuilight
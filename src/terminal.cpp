@@ -1,208 +1,352 @@
 #include "tuilight/terminal.h"
 #include "tuilight/ansi.h"
 #include <csignal>
-#include <iostream>
+#include <optional>
 #include <poll.h>
 #include <stdexcept>
+#include <utility>
 
 namespace wibens::tuilight
 {
 using namespace ansi;
 
-static Terminal *handlingTerminal = nullptr;
+// The signal handler may only touch lock-free atomics and async-signal-safe calls
+static std::atomic<int> wakeFd{-1};
+static std::atomic<bool> resized{false};
+static_assert(std::atomic<int>::is_always_lock_free && std::atomic<bool>::is_always_lock_free);
+static constexpr auto escapeTimeout = std::chrono::milliseconds(25);
+static constexpr std::string_view enableBracketedPaste = "\033[?2004h";
+static constexpr std::string_view disableBracketedPaste = "\033[?2004l";
 
-Terminal::Terminal() : restore(rawTerminal())
+Terminal::Terminal(int outputFd) : restore(rawTerminal()), out(outputFd), callbacks(1024)
 {
-    showCursor(false);
+    showCursor(out, false);
+    out.append(enableBracketedPaste);
     int flags = fcntl(STDIN_FILENO, F_GETFL, 0);
     fcntl(STDIN_FILENO, F_SETFL, flags | O_NONBLOCK);
 
-    handlingTerminal = this;
+    // Both ends are non-blocking: a full pipe already guarantees a wakeup, and the loop drains it completely
+    if (pipe2(pipeFd, O_NONBLOCK | O_CLOEXEC) == -1) {
+        throw std::system_error(errno, std::generic_category(), "pipe failed");
+    }
+    wakeFd = pipeFd[1];
+
     struct sigaction sa;
     sa.sa_handler = [](int sig) {
-        if (handlingTerminal != nullptr) {
-            handlingTerminal->post([](Terminal &, BaseElement) {});
-        }
+        auto savedErrno = errno;
+        resized = true;
+        char c = 'W';
+        [[maybe_unused]] auto ret = ::write(wakeFd, &c, 1);
+        errno = savedErrno;
     };
     sigemptyset(&sa.sa_mask);
-    sa.sa_flags = 0;
+    sa.sa_flags = SA_RESTART;
     if (sigaction(SIGWINCH, &sa, nullptr) == -1) {
         throw std::system_error(errno, std::generic_category(), "sigaction failed");
     }
-
-    if (pipe(pipeFd) == -1) {
-        throw std::system_error(errno, std::generic_category(), "pipe failed");
-    }
+    resized = false;
+    updateSize();
 }
 
 Terminal::~Terminal()
 {
-    showCursor(true);
-    handlingTerminal = nullptr;
+    setOutputThread(false);
+    showCursor(out, true);
+    out.append(disableBracketedPaste);
+    out.flush();
+    signal(SIGWINCH, SIG_DFL);
+    wakeFd = -1;
+    close(pipeFd[0]);
+    close(pipeFd[1]);
 }
 
-void Terminal::render(BaseElement e)
+void Terminal::updateSize()
 {
-    clear();
-    moveCursor(0, 0);
-    auto size = getTerminalSize();
+    auto size = getTerminalSize(out.fd());
     width = size.cols;
     height = size.rows;
+}
+
+void Terminal::render(BaseElement e)
+{
+    // The size is only queried again after SIGWINCH
+    if (resized.exchange(false)) {
+        updateSize();
+        e->invalidate();
+        if (resizeHandler) {
+            resizeHandler(*this, width, height);
+        }
+    }
+    FrameProfile profile;
+    if (profile) {
+        // Sizes are cached, measuring the tree first keeps layout apart from drawing
+        e->getSize();
+        profile.lap(&FrameStats::layout, "layout");
+    }
+    auto &screen = canvas();
+    if (screen.width != width || screen.height != height) {
+        screen.resize(width, height);
+    }
+    screen.clear();
     e->render(*this);
-    std::cout.flush();
+    profile.lap(&FrameStats::render, "render");
+    flush();
+    profile.lap(&FrameStats::output, "output");
+    // Kept up to date while profiling is off as well, so the first profiled frame does not count everything before it
+    auto bytes = bytesWritten();
+    auto cells = cellsWritten();
+    auto writes = writeCalls();
+    profile.stats.bytes = bytes - std::exchange(profiledBytes, bytes);
+    profile.stats.cellsChanged = cells - std::exchange(profiledCells, cells);
+    profile.stats.syscalls = writes - std::exchange(profiledWrites, writes);
+    profile.finish();
 }
 
-void Terminal::clear() { ansi::clear(); }
+void Terminal::flush()
+{
+    if (outputThread.joinable()) {
+        if (outputFailed.exchange(false, std::memory_order_acquire)) {
+            // The writer has stopped, later frames are written on this thread again so their errors surface as well.
+            // What reached the terminal is unknown, the next frame starts from a cleared screen.
+            outputRunning = false;
+            outputThread.join();
+            encoder.clear(out);
+            std::rethrow_exception(std::exchange(outputError, nullptr));
+        }
+        frames.publish();
+        wakeOutput();
+        return;
+    }
+    encoder.encode(back, out);
+    out.flush();
+}
+
+void Terminal::clear()
+{
+    if (outputThread.joinable()) {
+        clearRequested = true;
+        wakeOutput();
+    } else {
+        encoder.clear(out);
+    }
+}
+
+void Terminal::setOutputThread(bool enable)
+{
+    if (enable == outputThread.joinable()) {
+        return;
+    }
+    if (enable) {
+        outputRunning = true;
+        outputThread = std::thread(&Terminal::writeFrames, this);
+    } else {
+        outputRunning = false;
+        wakeOutput();
+        outputThread.join();
+    }
+}
+
+void Terminal::wakeOutput()
+{
+    outputWakeups.fetch_add(1, std::memory_order_release);
+    outputWakeups.notify_one();
+}
+
+void Terminal::writeFrames()
+{
+    try {
+        auto seen = outputWakeups.load(std::memory_order_acquire);
+        while (true) {
+            if (clearRequested.exchange(false)) {
+                encoder.clear(out);
+            }
+            if (frames.update()) {
+                encoder.encode(frames.readBuffer(), out);
+            }
+            out.flush();
+            threadBytesWritten.store(out.bytesWritten(), std::memory_order_relaxed);
+            threadCellsWritten.store(encoder.cellsWritten(), std::memory_order_relaxed);
+            threadWriteCalls.store(out.writeCalls(), std::memory_order_relaxed);
+            if (!outputRunning) {
+                return;
+            }
+            outputWakeups.wait(seen, std::memory_order_acquire);
+            seen = outputWakeups.load(std::memory_order_acquire);
+        }
+    } catch (...) {
+        // Rethrown by the next flush() on the loop thread
+        outputError = std::current_exception();
+        outputFailed.store(true, std::memory_order_release);
+    }
+}
 
 void Terminal::runInteractive(BaseElement e)
 {
     running = true;
     e = NoEscape(e);
-    if (e->focusable()) {
-        e->setFocus(true);
-    }
+    // Also when nothing can take the focus yet, so whatever becomes focusable later gets it
+    e->setFocus(true);
+    render(e);
+    auto lastFrame = std::chrono::steady_clock::now();
+    bool changed = false;
+    // When the next frame or timer is due
+    auto wakeup = [&]() -> std::optional<std::chrono::steady_clock::time_point> {
+        auto deadline = timers.nextDeadline();
+        if (changed && (!deadline || lastFrame + frameInterval < *deadline)) {
+            return lastFrame + frameInterval;
+        }
+        return deadline;
+    };
     while (running) {
-        clear();
-        render(e);
-        auto key = keyPress();
-        if (key > KeyEvent::UNKNOWN) {
-            e->handleEvent(key);
+        int timeout = -1;
+        if (auto time = wakeup()) {
+            auto wait = *time - std::chrono::steady_clock::now();
+            timeout = std::max<int>(0, std::chrono::ceil<std::chrono::milliseconds>(wait).count());
+        }
+        // Handle everything that is pending before drawing a single frame for all of it, unless more keeps arriving
+        // past the time the frame or a timer is due
+        for (auto *batch = &readInput(timeout); running && !batch->empty(); batch = &readInput(0)) {
+            for (const auto &event : *batch) {
+                if (!running) {
+                    break;
+                }
+                changed = dispatch(event, e) || changed;
+            }
+            if (auto time = wakeup(); time && std::chrono::steady_clock::now() >= *time) {
+                break;
+            }
         }
-        while (!callbacks.empty()) {
-            callbacks.back()(*this, e);
-            callbacks.pop_back();
+        auto now = std::chrono::steady_clock::now();
+        if (running && timers.advance(now, *this, e) > 0) {
+            changed = true;
         }
+        if (running && changed && now >= lastFrame + frameInterval) {
+            render(e);
+            lastFrame = now;
+            changed = false;
+        }
+    }
+}
+
+bool Terminal::dispatch(const InputEvent &event, BaseElement e)
+{
+    switch (event.key) {
+        case KeyEvent::INTERRUPT:
+            return runCallbacks(e) || resized;
+        case KeyEvent::PASTE:
+            return e->handlePaste(event.text);
+        default:
+            return event.key > KeyEvent::UNKNOWN && e->handleEvent(event.key);
     }
 }
 
+bool Terminal::runCallbacks(BaseElement e)
+{
+    // Only what was queued on entry runs, work posted by the batch waits for the next wakeup so a callback that posts
+    // itself cannot starve the loop
+    bool ran = false;
+    Callback callback;
+    for (auto queued = callbacks.size(); queued > 0 && callbacks.pop(callback); --queued) {
+        callback(*this, e);
+        ran = true;
+    }
+    return ran;
+}
+
+void Terminal::setMaxFps(unsigned fps)
+{
+    using namespace std::chrono;
+    frameInterval = fps == 0 ? steady_clock::duration{} : duration_cast<steady_clock::duration>(seconds(1)) / fps;
+}
+
 void Terminal::write(std::size_t column, std::size_t row, Style style, std::string_view data)
 {
-    moveCursor(column, row);
-    printStyle(style);
-    std::cout << data;
+    canvas().write(column, row, style, data);
 };
+void Terminal::blit(std::size_t column, std::size_t row, const Screen &source, std::size_t width, std::size_t height)
+{
+    canvas().blit(column, row, source, width, height);
+}
+void Terminal::fill(std::size_t column, std::size_t row, std::size_t width, std::size_t height, Style style,
+                    char32_t c)
+{
+    canvas().fill(column, row, width, height, style, c);
+}
 void Terminal::printStyle(const Style &style)
 {
-    setStyle(StyleCode::Reset);
-    if (style.bold) {
-        setStyle(StyleCode::Bold);
-    }
-    if (style.underline) {
-        setStyle(StyleCode::Underline);
-    }
-    if (style.blink) {
-        setStyle(StyleCode::Blink);
-    }
-    if (style.dim) {
-        setStyle(StyleCode::Dim);
-    }
-    if (style.invert) {
-        setStyle(StyleCode::Invert);
-    }
-    if (style.hidden) {
-        setStyle(StyleCode::Hidden);
-    }
-    if (style.fgColor.has_value()) {
-        auto code = static_cast<unsigned>(style.fgColor.value()) + static_cast<unsigned>(ColorCode::Black);
-        if (style.fgColor.value() >= Color::Gray) {
-            code = static_cast<unsigned>(style.fgColor.value()) - static_cast<unsigned>(Color::Gray) +
-                   static_cast<unsigned>(ColorCode::Gray);
-        }
-        auto color = static_cast<ColorCode>(code);
-        setForegroundColor(color);
-    }
-    if (style.bgColor.has_value()) {
-        auto code = static_cast<unsigned>(style.bgColor.value()) + static_cast<unsigned>(ColorCode::Black);
-        if (style.bgColor.value() >= Color::Gray) {
-            code = static_cast<unsigned>(style.bgColor.value()) - static_cast<unsigned>(Color::Gray) +
-                   static_cast<unsigned>(ColorCode::Gray);
-        }
-        auto color = static_cast<ColorCode>(code);
-        setBackgroundColor(color);
-    }
+    encoder.setStyle(style, out);
 }
 
-void Terminal::post(std::function<void(Terminal &, BaseElement)> fun)
+bool Terminal::post(Callback fun)
 {
-    callbacks.push_front(fun);
+    if (!callbacks.push(std::move(fun))) {
+        return false;
+    }
     char c = 'E';
-    if (::write(pipeFd[1], &c, 1) == -1) {
+    if (::write(pipeFd[1], &c, 1) == -1 && errno != EAGAIN) {
         throw std::system_error(errno, std::generic_category(), "write failed");
     }
+    return true;
+}
+
+Terminal::TimerId Terminal::setTimeout(std::chrono::milliseconds delay, Callback callback)
+{
+    return timers.add(std::chrono::steady_clock::now(), delay, std::move(callback));
+}
+
+Terminal::TimerId Terminal::setInterval(std::chrono::milliseconds interval, Callback callback)
+{
+    return timers.add(std::chrono::steady_clock::now(), interval, std::move(callback), interval);
 }
 
-void Terminal::postKeyPress(KeyEvent event)
+bool Terminal::postKeyPress(KeyEvent event)
 {
-    post([event](Terminal &, BaseElement e) { e->handleEvent(event); });
+    return post([event](Terminal &, BaseElement e) { e->handleEvent(event); });
 }
 
-// Function to read a key press event
-KeyEvent Terminal::keyPress()
+const std::vector<InputEvent> &Terminal::readInput(int timeout)
 {
-    // Set up the pollfd structure for monitoring stdin
+    events.clear();
+    auto now = std::chrono::steady_clock::now();
+    if (parser.pending()) {
+        // A lone ESC only becomes the escape key once no continuation arrived for a while
+        auto wait = std::chrono::ceil<std::chrono::milliseconds>(lastInput + escapeTimeout - now).count();
+        timeout = timeout < 0 ? std::max<int>(wait, 0) : std::clamp<int>(wait, 0, timeout);
+    }
+
     std::array<struct pollfd, 2> pollFds;
-    pollFds[0].fd = STDIN_FILENO; // File descriptor for stdin
-    pollFds[0].events = POLLIN;   // Poll for input events
-    pollFds[1].fd = pipeFd[0];    // File descriptor for pipe
-    pollFds[1].events = POLLIN;   // Poll for input events
+    pollFds[0].fd = STDIN_FILENO;
+    pollFds[0].events = POLLIN;
+    pollFds[1].fd = pipeFd[0];
+    pollFds[1].events = POLLIN;
 
-    int ret = poll(pollFds.data(), pollFds.size(), -1);
+    int ret = poll(pollFds.data(), pollFds.size(), timeout);
+    if (ret < 0) {
+        if (errno == EINTR) {
+            return events;
+        }
+        throw std::system_error(errno, std::generic_category(), "poll failed");
+    }
     if (ret == 0) {
-        return KeyEvent::TIMEOUT;
+        if (parser.pending() && std::chrono::steady_clock::now() >= lastInput + escapeTimeout) {
+            parser.timeout(events);
+        }
+        return events;
     }
     if (pollFds[1].revents) {
-        char c;
-        if (::read(pollFds[1].fd, &c, 1) == -1) {
-            throw std::system_error(errno, std::generic_category(), "read failed");
+        while (::read(pollFds[1].fd, inputBuffer.data(), inputBuffer.size()) > 0) {
         }
-        return KeyEvent::INTERRUPT;
-    }
-
-    auto c = getchar();
-    if (c != 0x1b) {
-        return CharEvent(c);
-    }
-    std::array<char, 4> seq;
-    for (auto &s : seq) {
-        s = getchar();
-    }
-    if (seq[0] != 0x5b) {
-        return KeyEvent::ESCAPE;
-    }
-
-    switch (seq[1]) {
-        case 0x32:
-            return KeyEvent::INSERT;
-        case 0x33:
-            return KeyEvent::DELETE;
-        case 0x41:
-            return KeyEvent::UP;
-        case 0x42:
-            return KeyEvent::DOWN;
-        case 0x43:
-            return KeyEvent::RIGHT;
-        case 0x44:
-            return KeyEvent::LEFT;
-        case 0x46:
-            return KeyEvent::END;
-        case 0x48:
-            return KeyEvent::HOME;
-        case 0x5a:
-            return KeyEvent::BACKTAB;
-    };
-    switch (seq[1]) {
-        case 0x35:
-            return KeyEvent::PAGE_UP;
-        case 0x36:
-            return KeyEvent::PAGE_DOWN;
+        events.push_back({KeyEvent::INTERRUPT});
     }
-    if (seq[1] == 0x31) {
-        return static_cast<KeyEvent>(static_cast<int>(KeyEvent::F1) + seq[2] - 0x31);
-    }
-    if (seq[1] == 0x32) {
-        return static_cast<KeyEvent>(static_cast<int>(KeyEvent::F9) + seq[2] - 0x30);
+    if (pollFds[0].revents) {
+        // stdin is non-blocking, so this reads exactly what has arrived so far
+        ssize_t count;
+        while ((count = ::read(STDIN_FILENO, inputBuffer.data(), inputBuffer.size())) > 0) {
+            parser.feed(std::string_view(inputBuffer.data(), count), events);
+        }
+        lastInput = std::chrono::steady_clock::now();
     }
-    return KeyEvent::UNKNOWN;
+    return events;
 }
 
 } // namespace wibens::tuilight
@@ -0,0 +1,134 @@
+#include "tuilight/threadpool.h"
+
+namespace wibens::tuilight
+{
+
+namespace
+{
+// The pool the current thread is working for, to detect nested runs
+thread_local const ThreadPool *activePool = nullptr;
+} // namespace
+
+ThreadPool::ThreadPool(std::size_t workerCount)
+{
+    // The last queue belongs to the thread calling run()
+    for (std::size_t i = 0; i <= workerCount; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    stopping = true;
+    generation.fetch_add(1, std::memory_order_release);
+    generation.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+ThreadPool &ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+bool ThreadPool::inRun() const { return activePool == this; }
+
+void ThreadPool::run(std::size_t count, const Task &job)
+{
+    if (inRun() || workers.empty()) {
+        for (std::size_t i = 0; i < count; ++i) {
+            job(i);
+        }
+        return;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    std::lock_guard lock(running);
+    task = &job;
+    error = nullptr;
+    remaining.store(count, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto &queue = *queues[i % queues.size()];
+        std::lock_guard queueLock(queue.mutex);
+        queue.items.push_back(i);
+    }
+    generation.fetch_add(1, std::memory_order_release);
+    generation.notify_all();
+
+    activePool = this;
+    while (runOne(queues.size() - 1)) {
+    }
+    for (auto left = remaining.load(std::memory_order_acquire); left != 0;
+         left = remaining.load(std::memory_order_acquire)) {
+        remaining.wait(left, std::memory_order_acquire);
+    }
+    activePool = nullptr;
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::work(std::size_t self)
+{
+    activePool = this;
+    // Not loaded here: a worker that only starts running after a run or the destructor bumped the generation would
+    // wait for the next one, and never return if that was the stop
+    std::uint32_t seen = 0;
+    while (true) {
+        generation.wait(seen, std::memory_order_acquire);
+        seen = generation.load(std::memory_order_acquire);
+        if (stopping) {
+            return;
+        }
+        while (runOne(self)) {
+        }
+    }
+}
+
+bool ThreadPool::runOne(std::size_t self)
+{
+    std::size_t index{};
+    bool found = false;
+    for (std::size_t i = 0; i < queues.size() && !found; ++i) {
+        auto &queue = *queues[(self + i) % queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (queue.items.empty()) {
+            continue;
+        }
+        // The owner takes from the front, thieves from the back
+        if (i == 0) {
+            index = queue.items.front();
+            queue.items.pop_front();
+        } else {
+            index = queue.items.back();
+            queue.items.pop_back();
+        }
+        found = true;
+    }
+    if (!found) {
+        return false;
+    }
+
+    try {
+        (*task)(index);
+    } catch (...) {
+        std::lock_guard lock(errorMutex);
+        if (!error) {
+            error = std::current_exception();
+        }
+    }
+    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        remaining.notify_all();
+    }
+    return true;
+}
+
+} // namespace wibens::tuilight
@@ -1,8 +1,7 @@
 #pragma once
 
+#include "output.h"
 #include <fcntl.h>
-#include <format>
-#include <iostream>
 #include <string.h>
 #include <string>
 #include <string_view>
@@ -42,22 +41,58 @@ enum class StyleCode : unsigned {
     Hidden = 8,
 };
 
-inline void setForegroundColor(ColorCode color) { std::cout << std::format("\033[{}m", static_cast<unsigned>(color)); }
-inline void setBackgroundColor(ColorCode color)
+inline void setForegroundColor(OutputBuffer &out, ColorCode color)
 {
-    std::cout << std::format("\033[{}m", static_cast<unsigned>(color) + 10);
+    out.append("\033[");
+    out.appendNumber(static_cast<unsigned>(color));
+    out.append('m');
 }
-inline void setStyle(StyleCode style) { std::cout << std::format("\033[{}m", static_cast<unsigned>(style)); }
-inline void showCursor(bool show)
+inline void setBackgroundColor(OutputBuffer &out, ColorCode color)
+{
+    out.append("\033[");
+    out.appendNumber(static_cast<unsigned>(color) + 10);
+    out.append('m');
+}
+inline void setStyle(OutputBuffer &out, StyleCode style)
+{
+    out.append("\033[");
+    out.appendNumber(static_cast<unsigned>(style));
+    out.append('m');
+}
+inline void showCursor(OutputBuffer &out, bool show)
 {
     if (show) {
-        std::cout << "\033[?25h";
+        out.append("\033[?25h");
     } else {
-        std::cout << "\033[?25l";
+        out.append("\033[?25l");
     }
 }
-inline void clear() { std::cout << "\033[2J"; }
-inline void moveCursor(int x, int y) { std::cout << std::format("\033[{};{}H", y + 1, x + 1); }
+inline void clear(OutputBuffer &out) { out.append("\033[2J"); }
+inline void moveCursor(OutputBuffer &out, int x, int y)
+{
+    out.append("\033[");
+    out.appendNumber(y + 1);
+    out.append(';');
+    out.appendNumber(x + 1);
+    out.append('H');
+}
+// Limits scrolling to rows [top, bottom), also moves the cursor home
+inline void setScrollRegion(OutputBuffer &out, int top, int bottom)
+{
+    out.append("\033[");
+    out.appendNumber(top + 1);
+    out.append(';');
+    out.appendNumber(bottom);
+    out.append('r');
+}
+inline void resetScrollRegion(OutputBuffer &out) { out.append("\033[r"); }
+// Positive lines move the content up, negative lines move it down
+inline void scroll(OutputBuffer &out, int lines)
+{
+    out.append("\033[");
+    out.appendNumber(lines > 0 ? lines : -lines);
+    out.append(lines > 0 ? 'S' : 'T');
+}
 
 struct TerminalSize {
     std::size_t rows;
@@ -75,10 +110,10 @@ struct TerminalRestorer {
     struct termios original;
 };
 
-inline TerminalSize getTerminalSize()
+inline TerminalSize getTerminalSize(int fd = STDOUT_FILENO)
 {
-    struct winsize ws;
-    ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws);
+    struct winsize ws {};
+    ioctl(fd, TIOCGWINSZ, &ws);
     return {ws.ws_row, ws.ws_col};
 }
 
@@ -123,7 +158,24 @@ enum class KeyEvent {
     F10,
     F11,
     F12,
+    PASTE,
+};
+inline KeyEvent CharEvent(char c) { return static_cast<KeyEvent>(static_cast<unsigned char>(c)); }
+
+enum class KeyModifier : int {
+    SHIFT = 1 << 24,
+    ALT = 1 << 25,
+    CTRL = 1 << 26,
 };
-inline KeyEvent CharEvent(char c) { return static_cast<KeyEvent>(c); }
+constexpr int keyModifierMask = 7 << 24;
+inline KeyEvent operator|(KeyEvent key, KeyModifier modifier)
+{
+    return static_cast<KeyEvent>(static_cast<int>(key) | static_cast<int>(modifier));
+}
+inline bool hasModifier(KeyEvent key, KeyModifier modifier)
+{
+    return (static_cast<int>(key) & static_cast<int>(modifier)) != 0;
+}
+inline KeyEvent baseKey(KeyEvent key) { return static_cast<KeyEvent>(static_cast<int>(key) & ~keyModifierMask); }
 
 } // namespace wibens::tuilight::ansi
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace wibens::tuilight
+{
+
+// Bump allocator for element trees that are rebuilt often. Elements created while a Scope is active are placed in the
+// arena and handed out as non-owning handles without a reference count; they are all destroyed together by reset() or
+// when the arena goes away, so the arena must outlive every use of the tree.
+class Arena
+{
+  public:
+    explicit Arena(std::size_t blockSize = 64 * 1024) : resource(blockSize) {}
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    ~Arena() { reset(); }
+
+    template <class D, class... Args> D *create(Args &&...args)
+    {
+        auto *object = new (resource.allocate(sizeof(D), alignof(D))) D(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<D>) {
+            auto *record = new (resource.allocate(sizeof(Destructor), alignof(Destructor)))
+                Destructor{destructors, object, [](void *p) { static_cast<D *>(p)->~D(); }};
+            destructors = record;
+        }
+        return object;
+    }
+
+    // Destroys all objects in reverse order of creation and releases the memory in one go
+    void reset();
+
+    class Scope
+    {
+      public:
+        explicit Scope(Arena &arena);
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+        ~Scope();
+
+      private:
+        Arena *previous;
+    };
+    // The arena of the innermost active Scope on this thread, if any
+    static Arena *current();
+
+  private:
+    struct Destructor {
+        Destructor *next;
+        void *object;
+        void (*destroy)(void *);
+    };
+
+    std::pmr::monotonic_buffer_resource resource;
+    Destructor *destructors = nullptr;
+};
+
+} // namespace wibens::tuilight
@@ -0,0 +1,36 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+namespace wibens::tuilight::debug
+{
+
+// Whether this executable links tuilight_count_allocations, which replaces the global operator new. The library
+// itself never does, it only reads the count.
+#ifdef TUILIGHT_COUNT_ALLOCATIONS
+constexpr bool countsAllocations = true;
+#else
+constexpr bool countsAllocations = false;
+#endif
+
+namespace detail
+{
+// Only ever incremented by the replaced operator new
+extern std::atomic<std::size_t> allocationCount;
+} // namespace detail
+
+// Heap allocations made by the whole process so far, always 0 unless allocations are counted
+std::size_t allocations();
+
+// Counts the allocations made during its lifetime, e.g. around a single frame
+class AllocationCounter
+{
+  public:
+    AllocationCounter() : start(allocations()) {}
+    std::size_t count() const { return allocations() - start; }
+
+  private:
+    std::size_t start;
+};
+
+} // namespace wibens::tuilight::debug
@@ -1,13 +1,24 @@
 #pragma once
 
+#include "arena.h"
 #include "tuilight/ansi.h"
+#include "unicode.h"
+#include "index.h"
+#include "profile.h"
+#include "screen.h"
+#include "threadpool.h"
 #include "view.h"
 #include <algorithm>
+#include <atomic>
+#include <concepts>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <stack>
 #include <string_view>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace wibens::tuilight
@@ -29,49 +40,229 @@ struct ElementSize {
     std::size_t maxHeight{};
 };
 
+class BaseElementImpl;
+using BaseElement = std::shared_ptr<BaseElementImpl>;
+
 class BaseElementImpl
 {
   public:
     virtual ~BaseElementImpl() = default;
     virtual void render(View &view) = 0;
-    virtual ElementSize getSize() const = 0;
+    ElementSize getSize() const
+    {
+        // Cleared before computing, so an invalidation that comes in meanwhile is not lost
+        if (layoutDirty.exchange(false, std::memory_order_relaxed)) {
+            cachedSize = computeSize();
+        }
+        return cachedSize;
+    }
+    // Drops the cached size of this element and all of its ancestors. Children of a parallel container call this
+    // while rendering, so their ancestors may be marked from several threads at once.
+    void invalidate()
+    {
+        layoutDirty.store(true, std::memory_order_relaxed);
+        if (parent != nullptr) {
+            parent->invalidate();
+        }
+        for (auto *other : otherParents) {
+            other->invalidate();
+        }
+    }
     virtual bool focusable() const { return false; }
-    virtual void setFocus(bool focus) { focused = focus; }
+    virtual void setFocus(bool focus)
+    {
+        if (focused != focus) {
+            focused = focus;
+            invalidate();
+        }
+    }
     bool isFocused() const { return focused; }
     virtual bool handleEvent(ansi::KeyEvent event) { return false; }
+    virtual bool handlePaste(std::string_view /*text*/) { return false; }
     virtual void focusFirst() { setFocus(true); }
     virtual void focusLast() { setFocus(true); }
+    // Spatial navigation: focuses what is closest to column, row of the area the element was last drawn in
+    virtual void focusNear(std::size_t /*column*/, std::size_t /*row*/) { setFocus(true); }
+    // Where the focus is within the area the element was last drawn in, as column and row
+    virtual std::pair<std::size_t, std::size_t> focusPosition() const { return {0, 0}; }
+
+  protected:
+    virtual ElementSize computeSize() const = 0;
+    // Tells the parents that focusable() may have changed, so they can keep track of what is focusable in them
+    void focusabilityChanged()
+    {
+        if (parent != nullptr) {
+            parent->childFocusabilityChanged(*this);
+        }
+        for (auto *other : otherParents) {
+            other->childFocusabilityChanged(*this);
+        }
+    }
+    // Called when focusable() of child may have changed, elements that wrap a single one pass it on
+    virtual void childFocusabilityChanged(const BaseElementImpl & /*child*/) { focusabilityChanged(); }
+    // Elements may be shared, each parent that adopts one is told about its changes until it releases it again
+    void adopt(const BaseElement &child)
+    {
+        if (child->parent == this || std::ranges::find(child->otherParents, this) != child->otherParents.end()) {
+            return;
+        }
+        if (child->parent == nullptr) {
+            child->parent = this;
+        } else {
+            child->otherParents.push_back(this);
+        }
+    }
+    void release(const BaseElement &child)
+    {
+        if (child->parent == this) {
+            child->parent = nullptr;
+            if (!child->otherParents.empty()) {
+                child->parent = child->otherParents.back();
+                child->otherParents.pop_back();
+            }
+        } else if (auto it = std::ranges::find(child->otherParents, this); it != child->otherParents.end()) {
+            child->otherParents.erase(it);
+        }
+    }
 
   private:
     bool focused = false;
+    // The first parent, the vector is only needed for elements that are shared
+    BaseElementImpl *parent = nullptr;
+    std::vector<BaseElementImpl *> otherParents;
+    mutable std::atomic<bool> layoutDirty = true;
+    mutable ElementSize cachedSize;
 };
-using BaseElement = std::shared_ptr<BaseElementImpl>;
 
 struct DecoratorImpl : BaseElementImpl {
     BaseElement inner;
-    DecoratorImpl(BaseElement inner) : inner(std::move(inner)) {}
+    DecoratorImpl(BaseElement inner) : inner(std::move(inner)) { adopt(this->inner); }
+    DecoratorImpl(const DecoratorImpl &) = delete;
+    DecoratorImpl &operator=(const DecoratorImpl &) = delete;
+    ~DecoratorImpl() override { release(inner); }
     void render(View &view) override { inner->render(view); }
-    ElementSize getSize() const override { return inner->getSize(); };
+    ElementSize computeSize() const override { return inner->getSize(); };
     bool focusable() const override { return inner->focusable(); }
     bool handleEvent(ansi::KeyEvent event) override { return inner->handleEvent(event); }
+    bool handlePaste(std::string_view text) override { return inner->handlePaste(text); }
     void setFocus(bool focused) override
     {
         BaseElementImpl::setFocus(focused);
         return inner->setFocus(focused);
     };
+    // Decorators that move inner by a few cells pass positions on unchanged, close enough to pick a neighbour
+    void focusNear(std::size_t column, std::size_t row) override
+    {
+        BaseElementImpl::setFocus(true);
+        inner->focusNear(column, row);
+    }
+    std::pair<std::size_t, std::size_t> focusPosition() const override { return inner->focusPosition(); }
 };
 using BaseDecorator = std::shared_ptr<DecoratorImpl>;
 
+namespace detail
+{
+template <class D, class... Args> std::shared_ptr<D> makeElement(Args &&...args)
+{
+    if (auto *arena = Arena::current()) {
+        // Aliasing an empty shared_ptr gives a handle without control block, copying it costs no refcount traffic
+        return std::shared_ptr<D>(std::shared_ptr<D>{}, arena->create<D>(std::forward<Args>(args)...));
+    }
+    return std::make_shared<D>(std::forward<Args>(args)...);
+}
+
+template <class D, class... Types>
+concept ElementArguments =
+    std::constructible_from<D, Types...> &&
+    !(sizeof...(Types) == 1 && (std::derived_from<std::remove_cvref_t<Types>, std::shared_ptr<D>> && ...));
+
+// A decorator that only changes the size or the style of what it wraps. Layers piped onto an element with | are
+// collected in a Composed value, which becomes a single Fused node once it is converted to a BaseElement. Layers
+// hide size() and render() to change them.
+template <class L> struct Layer {
+    ElementSize size(ElementSize inner) const { return inner; }
+    template <class Next> void render(View &view, Next &&next) const { next(view); }
+    auto operator()(BaseElement inner) const;
+};
+
+template <class T>
+concept IsLayer = std::derived_from<T, Layer<T>>;
+
+// Applies a chain of layers with one virtual call, the innermost layer comes first
+template <class... Layers> struct Fused : DecoratorImpl {
+    Fused(BaseElement inner, std::tuple<Layers...> layers) : DecoratorImpl(std::move(inner)), layers(std::move(layers))
+    {
+    }
+    void render(View &view) override { renderLayer<sizeof...(Layers)>(view); }
+    ElementSize computeSize() const override
+    {
+        auto size = inner->getSize();
+        std::apply([&size](const auto &...layer) { ((size = layer.size(size)), ...); }, layers);
+        return size;
+    }
+
+    std::tuple<Layers...> layers;
+
+  private:
+    template <std::size_t N> void renderLayer(View &view)
+    {
+        if constexpr (N == 0) {
+            inner->render(view);
+        } else {
+            std::get<N - 1>(layers).render(view, [this](View &next) { renderLayer<N - 1>(next); });
+        }
+    }
+};
+} // namespace detail
+
+template <class D> class Element;
+
+// An element with layers piped onto it that are not applied yet, see detail::Layer
+template <class... Layers> class Composed
+{
+  public:
+    Composed(BaseElement inner, std::tuple<Layers...> layers) : inner(std::move(inner)), layers(std::move(layers)) {}
+    template <class T> auto operator|(T decorator) const
+    {
+        if constexpr (detail::IsLayer<T>) {
+            return Composed<Layers..., T>(inner, std::tuple_cat(layers, std::tuple<T>(decorator)));
+        } else {
+            return decorator(BaseElement(*this));
+        }
+    }
+    operator BaseElement() const { return Element<detail::Fused<Layers...>>(inner, layers); }
+
+  private:
+    BaseElement inner;
+    std::tuple<Layers...> layers;
+};
+
 template <class D> class Element : public std::shared_ptr<D>
 {
   public:
     using Type = D;
     Element(std::shared_ptr<D> ptr) : std::shared_ptr<D>(std::move(ptr)) {}
-    template <class... Types> Element(Types... args) : std::shared_ptr<D>(std::make_shared<D>(args...)) {}
+    template <class... Types>
+        requires detail::ElementArguments<D, Types...>
+    Element(Types &&...args) : std::shared_ptr<D>(detail::makeElement<D>(std::forward<Types>(args)...))
+    {
+    }
     operator BaseElement() const { return std::static_pointer_cast<BaseElementImpl>(*this); }
-    template <class T> auto operator|(T decorator) { return decorator(*this); }
+    template <class T> auto operator|(T decorator)
+    {
+        if constexpr (detail::IsLayer<T>) {
+            return Composed<T>(*this, std::tuple<T>(decorator));
+        } else {
+            return decorator(*this);
+        }
+    }
 };
 
+template <class L> auto detail::Layer<L>::operator()(BaseElement inner) const
+{
+    return Element<Fused<L>>(std::move(inner), std::tuple<L>(static_cast<const L &>(*this)));
+}
+
 namespace detail
 {
 struct Center : DecoratorImpl {
@@ -79,24 +270,62 @@ struct Center : DecoratorImpl {
     void render(View &view) override;
 };
 
-struct ForegroundColor : DecoratorImpl {
-    ForegroundColor(BaseElement inner, Color color) : DecoratorImpl(inner), color(color) {}
-    void render(View &view) override;
-    Color color;
+struct ForegroundColor : Layer<ForegroundColor> {
+    explicit ForegroundColor(TermColor color) : color(color) {}
+    template <class Next> void render(View &view, Next &&next) const
+    {
+        view.viewStyle.setForeground(color);
+        next(view);
+    }
+
+    TermColor color;
 };
 
-struct BackgroundColor : ForegroundColor {
-    using ForegroundColor::ForegroundColor;
-    void render(View &view) override;
+struct BackgroundColor : Layer<BackgroundColor> {
+    explicit BackgroundColor(TermColor color) : color(color) {}
+    template <class Next> void render(View &view, Next &&next) const
+    {
+        view.viewStyle.setBackground(color);
+        next(view);
+    }
+
+    TermColor color;
+};
+
+// Sets an attribute, or flips it when toggled
+template <Style::Attribute A, bool Toggle = false> struct Attribute : Layer<Attribute<A, Toggle>> {
+    template <class Next> void render(View &view, Next &&next) const
+    {
+        if constexpr (Toggle) {
+            view.viewStyle.toggle(A);
+        } else {
+            view.viewStyle.set(A);
+        }
+        next(view);
+    }
 };
 
 struct Text : BaseElementImpl {
-    Text(std::string text, bool fill = false) : text(text), fill(fill) {}
+    Text(std::string text, bool fill = false)
+        : fill(fill), content(std::move(text)), columns(unicode::displayWidth(content))
+    {
+    }
     void render(View &view) override;
-    ElementSize getSize() const override { return {text.size(), 1}; }
+    ElementSize computeSize() const override { return {columns, 1}; }
+    const std::string &text() const { return content; }
+    void setText(std::string newText)
+    {
+        content = std::move(newText);
+        columns = unicode::displayWidth(content);
+        invalidate();
+    }
 
-    std::string text;
     bool fill;
+
+  private:
+    std::string content;
+    // Display width of content, measured once per change instead of every frame
+    std::size_t columns;
 };
 
 struct Button : Text {
@@ -111,116 +340,346 @@ struct Button : Text {
 
 struct VContainer : BaseElementImpl {
     VContainer(const std::vector<BaseElement> &elements);
+    VContainer(const VContainer &) = delete;
+    VContainer &operator=(const VContainer &) = delete;
+    ~VContainer() override;
     void render(View &view) override;
-    ElementSize getSize() const override;
-    bool focusable() const override { return !focusableChildren.empty(); }
+    ElementSize computeSize() const override;
+    void add(BaseElement element) { insert(elements.size(), std::move(element)); }
+    void insert(std::size_t index, BaseElement element);
+    void remove(std::size_t index);
+    bool focusable() const override { return focusIndex.count() > 0; }
     void setFocus(bool focus) override
     {
-        focusableChildren[focusedElement]->setFocus(focus);
+        if (focusable()) {
+            focusedChild()->setFocus(focus);
+        }
         BaseElementImpl::setFocus(focus);
     }
+    // Moves the focus to elements[index], which has to be focusable
     void focusChild(std::size_t index);
     bool handleEvent(ansi::KeyEvent event) override;
-    BaseElement focusedChild() const { return focusableChildren.at(focusedElement); }
-    void focusFirst() override { focusChild(0); }
-    void focusLast() override { focusChild(focusableChildren.size() - 1); }
+    bool handlePaste(std::string_view text) override { return focusable() && focusedChild()->handlePaste(text); }
+    BaseElement focusedChild() const { return elements.at(focusedElement); }
+    // Index of focusedChild() in children()
+    std::size_t focusedIndex() const { return focusedElement; }
+    const std::vector<BaseElement> &children() const { return elements; }
+    void focusFirst() override;
+    void focusLast() override;
+    void focusNear(std::size_t column, std::size_t row) override;
+    std::pair<std::size_t, std::size_t> focusPosition() const override;
+
+  protected:
+    struct Placement {
+        std::size_t x;
+        std::size_t y;
+        std::size_t width;
+        std::size_t height;
+    };
+    // Lays out the children in view, placements[i] is the area of children()[i]
+    virtual void place(const View &view);
+    // Which of the children are focusable
+    const FocusIndex &focusableChildren() const { return focusIndex; }
+    // The focusable child that was drawn closest to column, row
+    virtual std::size_t nearestFocusable(std::size_t column, std::size_t row) const;
+    // Focuses the next or previous focusable child. Spatial moves pick the part of it closest to the current focus.
+    bool moveFocus(bool forward, bool spatial);
+    void childFocusabilityChanged(const BaseElementImpl &child) override;
+
+    std::vector<Placement> placements;
 
+  private:
     std::vector<BaseElement> elements;
-    std::vector<BaseElement> focusableChildren;
+    // Which of the elements are focusable
+    FocusIndex focusIndex;
+    // Index in elements
     std::size_t focusedElement{};
 };
 
 struct HContainer : VContainer {
     HContainer(const std::vector<BaseElement> &elements) : VContainer(elements) {}
-    void render(View &view) override;
-    ElementSize getSize() const override;
+    ElementSize computeSize() const override;
     bool handleEvent(ansi::KeyEvent event) override;
+
+  protected:
+    void place(const View &view) override;
+    std::size_t nearestFocusable(std::size_t column, std::size_t row) const override;
 };
 
+// Renders each child concurrently into a screen of its own and copies those into place on the calling thread. Only
+// pays off for children that are expensive to draw; they must not share state that rendering modifies. Without
+// workers, nested in another parallel container on the same pool, or below minChildren children or minCells cells,
+// the children are drawn in place, one after another, instead.
+template <class Container> struct Parallel : Container {
+    Parallel(const std::vector<BaseElement> &elements, ThreadPool &pool) : Container(elements), pool(pool) {}
+    void render(View &view) override;
+
+    // Below these, waking the pool and copying every panel costs more than a single thread drawing it all
+    static constexpr std::size_t minChildren = 2;
+    static constexpr std::size_t minCells = 2048;
+
+    ThreadPool &pool;
+    std::vector<Screen> panels;
+};
+extern template struct Parallel<VContainer>;
+extern template struct Parallel<HContainer>;
+
 struct Bottom : DecoratorImpl {
     using DecoratorImpl::DecoratorImpl;
     void render(View &view) override;
 };
 
-struct Stretch : DecoratorImpl {
-    Stretch(BaseElement inner, std::size_t maxWidth, std::size_t maxHeight)
-        : DecoratorImpl(inner), maxWidth(maxWidth), maxHeight(maxHeight)
+struct Stretch : Layer<Stretch> {
+    Stretch(std::size_t maxWidth, std::size_t maxHeight) : maxWidth(maxWidth), maxHeight(maxHeight) {}
+    ElementSize size(ElementSize size) const
     {
+        size.maxWidth = std::max(size.maxWidth, maxWidth);
+        size.maxHeight = std::max(size.maxHeight, maxHeight);
+        return size;
     }
-    ElementSize getSize() const override;
 
     std::size_t maxWidth;
     std::size_t maxHeight;
 };
 
-struct Shrink : DecoratorImpl {
-    Shrink(BaseElement inner, std::size_t minWidth, std::size_t minHeight)
-        : DecoratorImpl(inner), minWidth(minWidth), minHeight(minHeight)
+struct Shrink : Layer<Shrink> {
+    Shrink(std::size_t minWidth, std::size_t minHeight) : minWidth(minWidth), minHeight(minHeight) {}
+    ElementSize size(ElementSize size) const
     {
+        size.minWidth = std::min(size.maxWidth, minWidth);
+        size.minHeight = std::min(size.maxHeight, minHeight);
+        return size;
     }
-    ElementSize getSize() const override;
 
     std::size_t minWidth;
     std::size_t minHeight;
 };
 
-struct Limit : DecoratorImpl {
-    Limit(BaseElement inner, std::size_t maxWidth, std::size_t maxHeight)
-        : DecoratorImpl(inner), maxWidth(maxWidth), maxHeight(maxHeight)
+// Stretches in both directions and shrinks to nothing
+struct Fit : Layer<Fit> {
+    ElementSize size(ElementSize size) const
     {
+        auto max = std::numeric_limits<std::size_t>::max();
+        return Shrink(0, 0).size(Stretch(max, max).size(size));
     }
-    void render(View &view) override;
+};
 
-    ElementSize getSize() const override;
+struct Limit : Layer<Limit> {
+    Limit(std::size_t maxWidth, std::size_t maxHeight) : maxWidth(maxWidth), maxHeight(maxHeight) {}
+    ElementSize size(ElementSize size) const
+    {
+        size.minWidth = std::min(size.minWidth, maxWidth);
+        size.minHeight = std::min(size.minHeight, maxHeight);
+        size.maxWidth = std::min(size.maxWidth, maxWidth);
+        size.maxHeight = std::min(size.maxHeight, maxHeight);
+        return size;
+    }
+    template <class Next> void render(View &view, Next &&next) const
+    {
+        if (view.width > maxWidth || view.height > maxHeight) {
+            SubView sv(view, 0, 0, std::min(maxWidth, view.width), std::min(maxHeight, view.height));
+            next(sv);
+        } else {
+            next(view);
+        }
+    }
 
     std::size_t maxWidth;
     std::size_t maxHeight;
 };
 
-using StyleFunc = void (*)(Style &);
-struct Styler : DecoratorImpl {
-    Styler(BaseElement inner, StyleFunc modifier) : DecoratorImpl(inner), modifier(modifier) {}
-    void render(View &view) override;
-
-    StyleFunc modifier;
-};
-
 struct Frame : DecoratorImpl {
     using DecoratorImpl::DecoratorImpl;
     void render(View &view) override;
-    ElementSize getSize() const override;
+    ElementSize computeSize() const override;
 };
 
 struct Selectable : DecoratorImpl {
     using DecoratorImpl::DecoratorImpl;
 
     inline bool focusable() const override { return true; }
-    inline ElementSize getSize() const override { return inner->getSize(); };
     void render(View &view) override;
 };
 
+// Only the rows that intersect the viewport (and the focused row) are built and rendered. Row offsets come from a
+// HeightIndex, so scrolling and paging cost O(log n) regardless of the number of rows.
 struct VMenu : BaseElementImpl {
-    VMenu(const std::vector<BaseElement> &elements) : elements(elements) {}
+    using RowBuilder = std::function<BaseElement(std::size_t)>;
+    VMenu(const std::vector<BaseElement> &elements);
+    VMenu(std::size_t count, RowBuilder builder, std::size_t rowHeight = 1);
+    VMenu(const VMenu &) = delete;
+    VMenu &operator=(const VMenu &) = delete;
+    ~VMenu() override;
 
     void render(View &view) override;
-    ElementSize getSize() const override;
-    virtual bool focusable() const { return !elements.empty(); }
-    virtual void setFocus(bool focus)
+    ElementSize computeSize() const override;
+    bool focusable() const override { return focusIndex.count() > 0; }
+    void setFocus(bool focus) override
     {
-        elements[focusedIndex]->setFocus(focus);
+        if (rowCount > 0) {
+            focusedChild()->setFocus(focus);
+        }
         BaseElementImpl::setFocus(focus);
     }
     bool next();
     bool prev();
     bool handleEvent(ansi::KeyEvent event) override;
-    BaseElement focusedChild() const { return elements.at(focusedIndex); }
+    bool handlePaste(std::string_view text) override { return rowCount > 0 && focusedChild()->handlePaste(text); }
+    void focusNear(std::size_t column, std::size_t row) override;
+    std::pair<std::size_t, std::size_t> focusPosition() const override;
+    BaseElement focusedChild();
+    std::size_t size() const { return rowCount; }
+
+    // Only for menus created from a row builder
+    void setRowCount(std::size_t count);
+    void invalidateRow(std::size_t index);
 
   private:
+    using Row = std::pair<std::size_t, BaseElement>;
+    BaseElement row(std::size_t index);
+    void measure(std::size_t index, const BaseElement &element);
+    void focusRow(std::size_t index, BaseElement element = nullptr);
+    bool isCached(std::size_t index) const;
+    void drop(const BaseElement &element);
+    // The nearest focusable row at or after index, or before it. Rows that turn out not to be focusable once they are
+    // built are taken out of the focus index on the way.
+    Row findFocusable(std::size_t index, bool forward);
+    void childFocusabilityChanged(const BaseElementImpl &child) override;
+
     std::vector<BaseElement> elements;
+    RowBuilder builder;
+    bool virtualRows;
+    std::size_t rowCount;
+    HeightIndex heights;
+    // Rows that were never built are assumed to be focusable
+    FocusIndex focusIndex{true};
+    std::vector<Row> rows;
+    std::vector<Row> nextRows;
+    BaseElement focusedRow;
     std::size_t focusedIndex{};
     std::size_t scrolledValue{};
-    mutable std::vector<long> offsets;
     std::size_t pageSize = 1;
+    std::size_t minWidth{};
+    std::size_t maxWidth{};
+    bool stretchable = false;
+};
+
+// The newest lines of a stream, kept in a ring buffer of fixed capacity. append() may be called from any thread: lines
+// are collected in a batch that is moved into the ring on the next render, so producers never wait for a frame.
+struct LogView : BaseElementImpl {
+    using Notify = std::function<void()>;
+    LogView(std::size_t capacity, Notify notify = {});
+
+    void render(View &view) override;
+    ElementSize computeSize() const override
+    {
+        return {0, 1, std::numeric_limits<std::size_t>::max(), std::numeric_limits<std::size_t>::max()};
+    }
+    bool focusable() const override { return true; }
+    bool handleEvent(ansi::KeyEvent event) override;
+
+    // Thread-safe, notify is called for the first line of each batch so the caller can wake up the render loop
+    void append(std::string line);
+    void clear();
+    std::size_t size() const { return count; }
+    // While following, the view sticks to the newest line. Scrolling up locks it in place until scrolled to the bottom.
+    bool following() const { return follow; }
+    void setFollowing(bool enable) { follow = enable; }
+
+  private:
+    void takePending();
+    void push(std::string &&line);
+    // Returns false when the view is already at the end it would move towards
+    bool scroll(long delta);
+    std::size_t lastTop() const { return firstLine + (count > pageSize ? count - pageSize : 0); }
+
+    std::vector<std::string> lines;
+    std::size_t head{};
+    std::size_t count{};
+    // Line numbers count every line ever appended, so the scroll position stays on the same line as old ones drop out
+    std::size_t firstLine{};
+    std::size_t top{};
+    std::size_t pageSize = 1;
+    bool follow = true;
+
+    Notify notify;
+    std::mutex mutex;
+    std::vector<std::string> pending;
+    std::vector<std::string> batch;
+};
+
+// A grid whose cells come from a provider. Only the cells that are visible are ever asked for, both rows and columns
+// scroll, so the number of rows does not affect the cost of a frame.
+struct Table : BaseElementImpl {
+    using CellProvider = std::function<std::string(std::size_t row, std::size_t column)>;
+    struct Column {
+        enum class Mode { Fixed, Auto, Stretch };
+        std::string title;
+        Mode mode = Mode::Auto;
+        // Fixed: the width, Auto: an upper bound (0 for none), Stretch: the minimum width
+        std::size_t width = 0;
+    };
+
+    Table(std::vector<Column> columns, std::size_t rowCount, CellProvider provider);
+
+    void render(View &view) override;
+    ElementSize computeSize() const override;
+    bool focusable() const override { return rowCount > 0; }
+    bool handleEvent(ansi::KeyEvent event) override;
+
+    std::size_t size() const { return rowCount; }
+    void setRowCount(std::size_t count);
+    std::size_t selectedRow() const { return selected; }
+    void selectRow(std::size_t row);
+    // Samples the rows again for the widths of auto columns, after the data changed
+    void measure();
+
+  private:
+    struct Placement {
+        std::size_t column;
+        std::size_t x;
+        std::size_t width;
+    };
+    void place(std::size_t width);
+
+    // Rows sampled, evenly spread over the table, to find the width of auto columns
+    static constexpr std::size_t sampledRows = 256;
+    static constexpr std::size_t columnGap = 1;
+
+    std::vector<Column> columns;
+    std::size_t rowCount;
+    CellProvider provider;
+    std::vector<std::size_t> widths;
+    std::vector<Placement> visible;
+    std::size_t selected{};
+    std::size_t scrolledRow{};
+    std::size_t firstColumn{};
+    std::size_t pageSize = 1;
+    bool clipped = false;
+};
+
+// Adds the time spent laying out and drawing inner to the profiler under a tag, while profiling is enabled
+struct Profile : DecoratorImpl {
+    Profile(BaseElement inner, std::string_view tag) : DecoratorImpl(inner), node(Profiler::instance().node(tag)) {}
+    void render(View &view) override;
+    ElementSize computeSize() const override;
+
+    Profiler::Node &node;
+};
+
+// Draws the statistics of the previous frame over the top right corner of inner. The toggle key shows and hides
+// them, the profiler is enabled while they are shown.
+struct StatsOverlay : DecoratorImpl {
+    StatsOverlay(BaseElement inner, ansi::KeyEvent toggle) : DecoratorImpl(inner), toggle(toggle) {}
+    void render(View &view) override;
+    bool handleEvent(ansi::KeyEvent event) override;
+
+    ansi::KeyEvent toggle;
+    bool shown = false;
+    bool wasEnabled = false;
+    // Only the slowest tagged subtrees of the frame are listed
+    static constexpr std::size_t maxTags = 8;
+    std::vector<NodeStats> nodes;
 };
 
 struct NoEscape : DecoratorImpl {
@@ -251,15 +710,9 @@ struct KeyHander : DecoratorImpl {
 
 inline auto Center(BaseElement inner) { return Element<detail::Center>(inner); }
 
-inline auto ForegroundColor(Color color)
-{
-    return [=](BaseElement inner) { return Element<detail::ForegroundColor>(inner, color); };
-}
+inline auto ForegroundColor(TermColor color) { return detail::ForegroundColor(color); }
 
-inline auto BackgroundColor(Color color)
-{
-    return [=](BaseElement inner) { return Element<detail::BackgroundColor>(inner, color); };
-}
+inline auto BackgroundColor(TermColor color) { return detail::BackgroundColor(color); }
 
 inline auto Text(const std::string &text, bool fill = false) { return Element<detail::Text>(text, fill); }
 
@@ -280,12 +733,22 @@ template <class... Elements> auto HContainer(Elements... elements)
     return HContainer(std::vector<BaseElement>{elements...});
 }
 
+inline auto ParallelVContainer(const std::vector<BaseElement> &elements, ThreadPool &pool = ThreadPool::shared())
+{
+    return Element<detail::Parallel<detail::VContainer>>(elements, pool);
+}
+
+inline auto ParallelHContainer(const std::vector<BaseElement> &elements, ThreadPool &pool = ThreadPool::shared())
+{
+    return Element<detail::Parallel<detail::HContainer>>(elements, pool);
+}
+
 inline auto Bottom(BaseElement inner) { return Element<detail::Bottom>(inner); }
 
 inline auto Stretch(std::size_t maxWidth = std::numeric_limits<std::size_t>::max(),
                     std::size_t maxHeight = std::numeric_limits<std::size_t>::max())
 {
-    return [=](BaseElement inner) { return Element<detail::Stretch>(inner, maxWidth, maxHeight); };
+    return detail::Stretch(maxWidth, maxHeight);
 }
 
 inline auto HStretch(std::size_t maxWidth = std::numeric_limits<std::size_t>::max()) { return Stretch(maxWidth, 0); }
@@ -293,42 +756,55 @@ inline auto VStretch(std::size_t maxHeight = std::numeric_limits<std::size_t>::m
 
 inline auto Shrink(std::size_t minWidth = 0, std::size_t minHeight = 0)
 {
-    return [=](BaseElement inner) { return Element<detail::Shrink>(inner, minWidth, minHeight); };
+    return detail::Shrink(minWidth, minHeight);
 }
 
 inline auto HShrink(std::size_t maxWidth = std::numeric_limits<std::size_t>::max()) { return Shrink(maxWidth, 0); }
 inline auto VShrink(std::size_t minHeight = 0) { return Shrink(0, minHeight); }
 
-inline auto Fit(BaseElement inner) { return Element<detail::Shrink>(Stretch()(inner), 0, 0); }
+inline constexpr detail::Fit Fit;
 
 inline auto Limit(std::size_t maxWidth = std::numeric_limits<std::size_t>::max(),
                   std::size_t maxHeight = std::numeric_limits<std::size_t>::max())
 {
-    return [=](BaseElement inner) { return Element<detail::Limit>(inner, maxWidth, maxHeight); };
+    return detail::Limit(maxWidth, maxHeight);
 }
 
-inline auto Bold(BaseElement inner)
+inline constexpr detail::Attribute<Style::Bold> Bold;
+inline constexpr detail::Attribute<Style::Dim> Dim;
+inline constexpr detail::Attribute<Style::Underline> Underline;
+inline constexpr detail::Attribute<Style::Invert, true> Invert;
+
+inline auto Frame(BaseElement inner) { return Element<detail::Frame>(inner); }
+
+inline auto Selectable(BaseElement inner) { return Element<detail::Selectable>(inner); }
+
+inline auto VMenu(const std::vector<BaseElement> &elements) { return Element<detail::VMenu>(elements); }
+inline auto VMenu(std::size_t count, detail::VMenu::RowBuilder builder, std::size_t rowHeight = 1)
 {
-    return Element<detail::Styler>(inner, [](Style &s) { s.bold = true; });
+    return Element<detail::VMenu>(count, builder, rowHeight);
 }
-inline auto Dim(BaseElement inner)
+
+inline auto LogView(std::size_t capacity, detail::LogView::Notify notify = {})
 {
-    return Element<detail::Styler>(inner, [](Style &s) { s.dim = true; });
+    return Element<detail::LogView>(capacity, notify);
 }
-inline auto Underline(BaseElement inner)
+
+inline auto Table(std::vector<detail::Table::Column> columns, std::size_t rowCount,
+                  detail::Table::CellProvider provider)
 {
-    return Element<detail::Styler>(inner, [](Style &s) { s.underline = true; });
+    return Element<detail::Table>(std::move(columns), rowCount, std::move(provider));
 }
-inline auto Invert(BaseElement inner)
+
+inline auto Profile(std::string_view tag)
 {
-    return Element<detail::Styler>(inner, [](Style &s) { s.invert = !s.invert; });
+    return [tag = std::string(tag)](BaseElement inner) { return Element<detail::Profile>(inner, tag); };
 }
 
-inline auto Frame(BaseElement inner) { return Element<detail::Frame>(inner); }
-
-inline auto Selectable(BaseElement inner) { return Element<detail::Selectable>(inner); }
-
-inline auto VMenu(const std::vector<BaseElement> &elements) { return Element<detail::VMenu>(elements); }
+inline auto StatsOverlay(ansi::KeyEvent toggle = ansi::KeyEvent::F12)
+{
+    return [=](BaseElement inner) { return Element<detail::StatsOverlay>(inner, toggle); };
+}
 
 inline auto NoEscape(BaseElement inner) { return Element<detail::NoEscape>(inner); }
 
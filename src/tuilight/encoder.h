@@ -0,0 +1,37 @@
+#pragma once
+#include "output.h"
+#include "screen.h"
+#include "sgr.h"
+#include <vector>
+
+namespace wibens::tuilight
+{
+
+// Remembers the frame that is displayed and turns a new frame into the escape sequences for the cells that differ
+class FrameEncoder
+{
+  public:
+    void encode(const Screen &next, OutputBuffer &out);
+    // Blanks the terminal, the next frame is then drawn on an empty screen
+    void clear(OutputBuffer &out);
+    void setStyle(const Style &style, OutputBuffer &out) { sgr.encode(style, out); }
+    const Screen &displayed() const { return front; }
+    // Cells sent to the terminal so far
+    std::size_t cellsWritten() const { return totalCells; }
+
+  private:
+    // Lets the terminal move rows that only shifted vertically, so they do not have to be sent again
+    void scroll(const Screen &next, OutputBuffer &out);
+
+    // Changed cells closer together than this are redrawn in one go instead of moving the cursor
+    static constexpr std::size_t mergeGap = 4;
+    // Scrolling costs three escape sequences, it has to save at least this many rows
+    static constexpr std::size_t minScrolledRows = 2;
+
+    Screen front;
+    SgrEncoder sgr;
+    std::vector<Run> runs;
+    std::size_t totalCells{};
+};
+
+} // namespace wibens::tuilight
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "debug.h"
+#include "element.h"
+#include "encoder.h"
+#include "input.h"
+#include "profile.h"
+#include "screen.h"
+#include <string>
+#include <string_view>
+
+namespace wibens::tuilight
+{
+using ansi::KeyEvent;
+
+// Renders into an in-memory cell grid of a fixed size instead of a tty, for tests, profiling and CI
+class HeadlessTerminal : public View
+{
+  public:
+    HeadlessTerminal(std::size_t width, std::size_t height);
+
+    void resize(std::size_t width, std::size_t height);
+    // Prepares the element like Terminal::runInteractive does and makes it the target of render() and input
+    void setRoot(BaseElement e);
+    void render();
+    void render(BaseElement e);
+    // Heap allocations made by the last render(), always 0 unless allocations are counted, see debug.h
+    std::size_t frameAllocations() const { return allocations; }
+
+    bool sendKey(KeyEvent event);
+    bool sendPaste(std::string_view text);
+    // Feeds raw terminal bytes through the same parser as Terminal, returns true when any event was handled
+    bool sendInput(std::string_view data);
+
+    void write(std::size_t column, std::size_t row, Style style, std::string_view data) override;
+    void blit(std::size_t column, std::size_t row, const Screen &source, std::size_t width,
+              std::size_t height) override;
+    void fill(std::size_t column, std::size_t row, std::size_t width, std::size_t height, Style style,
+              char32_t c = U' ') override;
+    // Appends the bytes a real terminal would receive for the current frame, returns how many were added
+    std::size_t encodeFrame(OutputBuffer &out);
+
+    const Screen &screen() const { return cells; }
+    Cell cell(std::size_t column, std::size_t row) const { return cells.cell(column, row); }
+    std::string rowText(std::size_t row) const;
+
+  private:
+    Screen cells;
+    BaseElement root;
+    FrameEncoder encoder;
+    InputParser parser;
+    std::vector<InputEvent> events;
+    std::size_t allocations{};
+};
+
+} // namespace wibens::tuilight
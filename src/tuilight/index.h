@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace wibens::tuilight
+{
+
+// Prefix sums over row heights. Rows that were never measured count as the default height, so a list of uniform rows
+// needs no storage at all; a Fenwick tree of deviations is only allocated once a row differs.
+class HeightIndex
+{
+  public:
+    explicit HeightIndex(std::size_t defaultHeight = 1) : defaultHeight(defaultHeight) {}
+
+    void resize(std::size_t count);
+    std::size_t size() const { return count; }
+
+    void set(std::size_t index, std::size_t height);
+    std::size_t height(std::size_t index) const { return offset(index + 1) - offset(index); }
+    // Sum of the heights of all rows before index
+    std::size_t offset(std::size_t index) const;
+    std::size_t total() const { return offset(count); }
+    // The row that covers the given vertical offset
+    std::size_t find(std::size_t offset) const;
+
+  private:
+    long long deviation(std::size_t index) const;
+
+    std::size_t count{};
+    std::size_t defaultHeight;
+    std::vector<long long> tree;
+};
+
+// Which entries of a list can take focus, with rank/select over them. Entries that were never set have the default
+// state, so a list where all are alike needs no storage; a Fenwick tree of the exceptions is only allocated once an
+// entry differs. Finding the next, previous, first or last focusable entry is O(log n), inserting or erasing one O(n).
+class FocusIndex
+{
+  public:
+    static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+    explicit FocusIndex(bool defaultFocusable = false) : defaultFocusable(defaultFocusable) {}
+
+    void resize(std::size_t count);
+    void insert(std::size_t index, bool focusable);
+    void erase(std::size_t index);
+    std::size_t size() const { return entries; }
+
+    void set(std::size_t index, bool focusable);
+    bool focusable(std::size_t index) const
+    {
+        return flipped.empty() ? defaultFocusable : defaultFocusable != flipped[index];
+    }
+    // Number of focusable entries
+    std::size_t count() const { return focusableCount; }
+    // Number of focusable entries before index
+    std::size_t rank(std::size_t index) const;
+    // Position of the focusable entry with the given rank, which must be below count()
+    std::size_t select(std::size_t rank) const;
+    // The first focusable entry at or after from, none if there is none
+    std::size_t next(std::size_t from) const;
+    // The last focusable entry before end, none if there is none
+    std::size_t prev(std::size_t end) const;
+
+  private:
+    std::size_t exceptions(std::size_t index) const;
+    void rebuild();
+
+    std::size_t entries{};
+    std::size_t focusableCount{};
+    bool defaultFocusable;
+    std::vector<bool> flipped;
+    std::vector<std::size_t> tree;
+};
+
+} // namespace wibens::tuilight
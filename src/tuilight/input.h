@@ -0,0 +1,36 @@
+#pragma once
+#include "ansi.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace wibens::tuilight
+{
+
+struct InputEvent {
+    ansi::KeyEvent key;
+    // The pasted text for KeyEvent::PASTE
+    std::string text{};
+};
+
+// Decodes the raw bytes read from the terminal into key events, any number of keys can be in one chunk and sequences
+// may be split across chunks
+class InputParser
+{
+  public:
+    void feed(std::string_view data, std::vector<InputEvent> &events);
+    // No more bytes arrived in time, a lone ESC was the escape key itself
+    void timeout(std::vector<InputEvent> &events);
+    // An unfinished escape sequence is buffered and waits for more bytes or a timeout
+    bool pending() const { return state == State::Escape || state == State::Csi || state == State::Ss3; }
+
+  private:
+    enum class State { Ground, Escape, Csi, Ss3, Paste };
+    void finishCsi(char final, std::vector<InputEvent> &events);
+
+    State state = State::Ground;
+    std::string parameters;
+    std::string paste;
+};
+
+} // namespace wibens::tuilight
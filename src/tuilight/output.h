@@ -0,0 +1,54 @@
+#pragma once
+#include "unicode.h"
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+namespace wibens::tuilight
+{
+
+// Collects all bytes of a frame so they can be sent with a single write
+class OutputBuffer
+{
+  public:
+    explicit OutputBuffer(int fd = STDOUT_FILENO, std::size_t capacity = 64 * 1024);
+
+    void append(std::string_view data) { buffer.append(data); }
+    void append(char c) { buffer.push_back(c); }
+    void appendCodepoint(char32_t c)
+    {
+        if (c < 0x80) {
+            buffer.push_back(static_cast<char>(c));
+        } else {
+            char bytes[4];
+            buffer.append(bytes, unicode::encode(c, bytes));
+        }
+    }
+    void appendNumber(unsigned value)
+    {
+        char digits[10];
+        auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+        buffer.append(digits, result.ptr);
+    }
+
+    void flush();
+    // Drops the collected bytes without writing them
+    void discard() { buffer.clear(); }
+    std::size_t size() const { return buffer.size(); }
+    std::size_t bytesWritten() const { return totalBytes; }
+    std::size_t writeCalls() const { return totalWrites; }
+
+    // Wrap every flush in DEC mode 2026 so supporting terminals never show a partially drawn frame
+    void setSynchronizedUpdate(bool enable) { synchronizedUpdate = enable; }
+    int fd() const { return outputFd; }
+
+  private:
+    int outputFd;
+    bool synchronizedUpdate = false;
+    std::string buffer;
+    std::size_t totalBytes{};
+    std::size_t totalWrites{};
+};
+
+} // namespace wibens::tuilight
@@ -0,0 +1,129 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace wibens::tuilight
+{
+
+// What it took to produce one frame. Output totals are counted since the previous frame, with an output thread they
+// belong to whatever that thread wrote in the meantime.
+struct FrameStats {
+    std::chrono::nanoseconds layout{};
+    std::chrono::nanoseconds render{};
+    std::chrono::nanoseconds output{};
+    std::size_t bytes{};
+    std::size_t cellsChanged{};
+    std::size_t syscalls{};
+};
+
+struct Timing {
+    std::size_t calls{};
+    std::chrono::nanoseconds time{};
+};
+
+// Time spent in a subtree tagged with Profile(), including everything below it
+struct NodeStats {
+    std::string tag;
+    // During the last frame
+    Timing layout;
+    Timing render;
+    // Since profiling was reset
+    Timing totalLayout;
+    Timing totalRender;
+};
+
+// Collects frame and subtree timings of the whole process. Costs a single atomic load per frame and tagged subtree
+// while disabled.
+class Profiler
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+    enum class Phase { Layout, Render };
+    struct Node;
+
+    static Profiler &instance();
+
+    bool enabled() const { return active.load(std::memory_order_relaxed); }
+    void setEnabled(bool enable) { active.store(enable, std::memory_order_relaxed); }
+    // Keeps every timed span as a trace event for writeChromeTrace(), up to maxTraceEvents
+    bool tracing() const { return traceActive.load(std::memory_order_relaxed); }
+    void setTracing(bool enable) { traceActive.store(enable, std::memory_order_relaxed); }
+    // Drops all statistics and trace events
+    void reset();
+
+    FrameStats lastFrame() const;
+    // The latest frames, oldest first
+    std::vector<FrameStats> history() const;
+    void nodes(std::vector<NodeStats> &out) const;
+    std::vector<NodeStats> nodes() const;
+    // Writes the trace events in the Chrome trace event format, for chrome://tracing or Perfetto
+    void writeChromeTrace(const std::string &path) const;
+
+    // The counters of a tag, the same node is returned for the same tag
+    Node &node(std::string_view tag);
+    void record(Node &node, Phase phase, Clock::time_point start, Clock::time_point end);
+    void trace(std::string_view name, std::string_view category, Clock::time_point start, Clock::time_point end);
+    void endFrame(const FrameStats &stats);
+
+    static constexpr std::size_t historySize = 120;
+    static constexpr std::size_t maxTraceEvents = 1 << 20;
+
+  private:
+    struct TraceEvent {
+        // Tags live as long as the profiler, the other names are literals
+        std::string_view name;
+        std::string_view category;
+        Clock::time_point start;
+        Clock::duration duration;
+        unsigned thread;
+    };
+
+    Profiler();
+
+    std::atomic<bool> active{false};
+    std::atomic<bool> traceActive{false};
+    Clock::time_point origin;
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Node>> tags;
+    std::vector<FrameStats> frames;
+    std::size_t frameCount{};
+    std::vector<TraceEvent> events;
+};
+
+struct Profiler::Node {
+    explicit Node(std::string_view tag) : tag(tag) {}
+
+    std::string tag;
+    std::array<std::atomic<std::uint64_t>, 2> calls{};
+    std::array<std::atomic<std::uint64_t>, 2> nanoseconds{};
+    NodeStats stats;
+};
+
+// Times the phases of one frame on the thread that draws it, does nothing while the profiler is disabled
+class FrameProfile
+{
+  public:
+    FrameProfile();
+    explicit operator bool() const { return active; }
+    // Ends the running phase and adds its time to stats.*phase
+    void lap(std::chrono::nanoseconds FrameStats::*phase, std::string_view name);
+    // Hands the stats to the profiler
+    void finish();
+
+    FrameStats stats;
+
+  private:
+    bool active;
+    Profiler::Clock::time_point frameStart;
+    Profiler::Clock::time_point phaseStart;
+};
+
+} // namespace wibens::tuilight
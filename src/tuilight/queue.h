@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+namespace wibens::tuilight
+{
+
+// Bounded lock-free queue for any number of producers and a single consumer, items are popped in the order in which
+// they were pushed
+template <class T> class BoundedQueue
+{
+  public:
+    explicit BoundedQueue(std::size_t capacity)
+        : slots(std::make_unique<Slot[]>(std::bit_ceil(capacity))), mask(std::bit_ceil(capacity) - 1)
+    {
+        for (std::size_t i = 0; i <= mask; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Returns false when the queue is full
+    bool push(T value)
+    {
+        auto position = head.load(std::memory_order_relaxed);
+        Slot *slot;
+        while (true) {
+            slot = &slots[position & mask];
+            auto sequence = slot->sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+            if (difference == 0) {
+                if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = head.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = std::move(value);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Must only be called from the consumer thread
+    bool pop(T &value)
+    {
+        auto &slot = slots[tail & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != tail + 1) {
+            return false;
+        }
+        value = std::move(slot.value);
+        slot.value = T{};
+        slot.sequence.store(tail + mask + 1, std::memory_order_release);
+        ++tail;
+        return true;
+    }
+
+    // Items pushed, or still being pushed, that were not popped yet. Only meaningful on the consumer thread.
+    std::size_t size() const { return head.load(std::memory_order_acquire) - tail; }
+    std::size_t capacity() const { return mask + 1; }
+
+  private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t mask;
+    alignas(64) std::atomic<std::size_t> head{};
+    alignas(64) std::size_t tail{};
+};
+
+} // namespace wibens::tuilight
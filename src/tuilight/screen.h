@@ -0,0 +1,98 @@
+#pragma once
+#include "view.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace wibens::tuilight
+{
+
+struct Cell {
+    // Marks the second column of a wide character
+    static constexpr char32_t continuation = 0;
+
+    char32_t character = U' ';
+    Style style{};
+
+    bool operator==(const Cell &) const = default;
+};
+
+// Columns [begin, end) of a row that have to be redrawn
+struct Run {
+    std::size_t begin;
+    std::size_t end;
+};
+
+// Cell grid stored as separate code point and style planes, so rows can be compared with SIMD instructions
+class Screen
+{
+  public:
+    Screen() = default;
+    Screen(std::size_t width, std::size_t height);
+
+    void resize(std::size_t width, std::size_t height);
+    void clear();
+    void write(std::size_t column, std::size_t row, Style style, std::string_view data);
+    void fill(std::size_t column, std::size_t row, std::size_t width, std::size_t height, Style style, char32_t c);
+
+    Cell cell(std::size_t column, std::size_t row) const
+    {
+        return {glyphs[row * width + column], styles[row * width + column]};
+    }
+    char32_t glyph(std::size_t column, std::size_t row) const { return glyphs[row * width + column]; }
+    Style style(std::size_t column, std::size_t row) const { return styles[row * width + column]; }
+
+    // Hash of a whole row, cached until the row is written to
+    std::uint64_t rowHash(std::size_t row) const;
+    void copyRow(const Screen &other, std::size_t row);
+    // Copies the top left width x height cells of source to column, row
+    void blit(std::size_t column, std::size_t row, const Screen &source, std::size_t width, std::size_t height);
+    // Moves rows [top, bottom) up by lines, or down when negative, like a terminal scroll region does
+    void scroll(std::size_t top, std::size_t bottom, int lines);
+
+    std::size_t width{};
+    std::size_t height{};
+
+  private:
+    void blankRows(std::size_t first, std::size_t last);
+
+    friend void diffRow(const Screen &next, const Screen &shown, std::size_t row, std::size_t mergeGap,
+                        std::vector<Run> &runs);
+
+    std::vector<char32_t> glyphs;
+    std::vector<Style> styles;
+    mutable std::vector<std::uint64_t> hashes;
+    mutable std::vector<bool> hashValid;
+    std::uint64_t blankHash{};
+};
+
+// A view that draws into a screen, e.g. one that is rendered on another thread and blitted into place afterwards
+class ScreenView : public View
+{
+  public:
+    ScreenView(Screen &screen, Style style = {}) : View(screen.width, screen.height, style), screen(screen) {}
+
+    void write(std::size_t column, std::size_t row, Style style, std::string_view data) override
+    {
+        screen.write(column, row, style, data);
+    }
+    void blit(std::size_t column, std::size_t row, const Screen &source, std::size_t width,
+              std::size_t height) override
+    {
+        screen.blit(column, row, source, width, height);
+    }
+    void fill(std::size_t column, std::size_t row, std::size_t width, std::size_t height, Style style,
+              char32_t c = U' ') override
+    {
+        screen.fill(column, row, width, height, style, c);
+    }
+
+  private:
+    Screen &screen;
+};
+
+// Appends the runs of columns in which a row of next differs from shown; runs separated by at most mergeGap equal
+// cells are joined, as rewriting those is cheaper than moving the cursor
+void diffRow(const Screen &next, const Screen &shown, std::size_t row, std::size_t mergeGap, std::vector<Run> &runs);
+
+} // namespace wibens::tuilight
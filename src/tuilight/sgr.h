@@ -0,0 +1,20 @@
+#pragma once
+#include "output.h"
+#include "view.h"
+#include <optional>
+
+namespace wibens::tuilight
+{
+
+// Tracks the SGR state of the terminal and produces the shortest escape sequence that changes it into a given style
+class SgrEncoder
+{
+  public:
+    void encode(const Style &style, OutputBuffer &out);
+    void reset() { current.reset(); }
+
+  private:
+    std::optional<Style> current;
+};
+
+} // namespace wibens::tuilight
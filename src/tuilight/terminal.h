@@ -1,9 +1,19 @@
 #pragma once
 
 #include "element.h"
+#include "encoder.h"
+#include "input.h"
+#include "profile.h"
+#include "queue.h"
+#include "screen.h"
+#include "timer.h"
+#include "triplebuffer.h"
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <exception>
 #include <functional>
-#include <list>
+#include <thread>
 
 namespace wibens::tuilight
 {
@@ -12,26 +22,98 @@ using ansi::KeyEvent;
 class Terminal : public View
 {
   public:
-    Terminal();
+    using Callback = std::function<void(Terminal &, BaseElement)>;
+    using ResizeHandler = std::function<void(Terminal &, std::size_t columns, std::size_t rows)>;
+    using TimerId = TimerWheel<Terminal &, BaseElement>::Id;
+
+    explicit Terminal(int outputFd = STDOUT_FILENO);
     ~Terminal();
 
     void render(BaseElement e);
+    void flush();
     void clear();
     void runInteractive(BaseElement e);
     void stop() { running = false; }
+    // Limits how often runInteractive repaints, 0 means no limit
+    void setMaxFps(unsigned fps);
+    // Called from render() after the terminal was resized, before the new frame is laid out
+    void onResize(ResizeHandler handler) { resizeHandler = std::move(handler); }
+    // Encodes and writes frames on a separate thread, so a slow terminal cannot hold up input handling. A frame that
+    // is finished while the previous one is still being written replaces any frame still waiting, so only the newest
+    // is shown. Every frame has to be drawn completely, as render() does, and printStyle() must not be used. A failed
+    // write is rethrown by the next flush(), which also stops the thread, so later frames are written directly.
+    void setOutputThread(bool enable);
 
-    KeyEvent keyPress();
+    // Waits up to timeout milliseconds and returns every event that arrived, empty on timeout
+    const std::vector<InputEvent> &readInput(int timeout = -1);
 
     void write(std::size_t column, std::size_t row, Style style, std::string_view data) override;
+    void blit(std::size_t column, std::size_t row, const Screen &source, std::size_t width,
+              std::size_t height) override;
+    void fill(std::size_t column, std::size_t row, std::size_t width, std::size_t height, Style style,
+              char32_t c = U' ') override;
     void printStyle(const Style &style);
+    void setSynchronizedUpdate(bool enable) { out.setSynchronizedUpdate(enable); }
+    std::size_t bytesWritten() const
+    {
+        return outputThread.joinable() ? threadBytesWritten.load(std::memory_order_relaxed) : out.bytesWritten();
+    }
+    std::size_t cellsWritten() const
+    {
+        return outputThread.joinable() ? threadCellsWritten.load(std::memory_order_relaxed) : encoder.cellsWritten();
+    }
+    std::size_t writeCalls() const
+    {
+        return outputThread.joinable() ? threadWriteCalls.load(std::memory_order_relaxed) : out.writeCalls();
+    }
+
+    // Thread-safe, callbacks run on the loop thread in FIFO order. Returns false when too much work is queued.
+    bool post(Callback fun);
+    bool postKeyPress(KeyEvent event);
 
-    void post(std::function<void(Terminal &, BaseElement)> fun);
-    void postKeyPress(KeyEvent event);
+    // Timers run on the loop thread of runInteractive, the next deadline bounds how long it waits for input and timers
+    // that are due together share a frame. Only to be used from the loop thread, other threads can post() instead.
+    TimerId setTimeout(std::chrono::milliseconds delay, Callback callback);
+    TimerId setInterval(std::chrono::milliseconds interval, Callback callback);
+    // Returns false when the timer already fired or was canceled before
+    bool cancelTimer(TimerId id) { return timers.cancel(id); }
 
   private:
+    void updateSize();
+    bool dispatch(const InputEvent &event, BaseElement e);
+    bool runCallbacks(BaseElement e);
+    Screen &canvas() { return outputThread.joinable() ? frames.writeBuffer() : back; }
+    void wakeOutput();
+    void writeFrames();
+
     ansi::TerminalRestorer restore;
+    Screen back;
+    OutputBuffer out;
+    FrameEncoder encoder;
     std::atomic<bool> running;
-    std::list<std::function<void(Terminal &, BaseElement)>> callbacks; // No need for locks
+    std::chrono::steady_clock::duration frameInterval{};
+    InputParser parser;
+    std::vector<InputEvent> events;
+    std::array<char, 4096> inputBuffer;
+    std::chrono::steady_clock::time_point lastInput;
+    BoundedQueue<Callback> callbacks;
+    TimerWheel<Terminal &, BaseElement> timers;
+    ResizeHandler resizeHandler;
     int pipeFd[2];
+    // Output totals at the end of the last frame
+    std::size_t profiledBytes{};
+    std::size_t profiledCells{};
+    std::size_t profiledWrites{};
+
+    TripleBuffer<Screen> frames;
+    std::thread outputThread;
+    std::atomic<bool> outputRunning{false};
+    std::atomic<std::uint32_t> outputWakeups{0};
+    std::atomic<bool> clearRequested{false};
+    std::atomic<std::size_t> threadBytesWritten{0};
+    std::atomic<std::size_t> threadCellsWritten{0};
+    std::atomic<std::size_t> threadWriteCalls{0};
+    std::atomic<bool> outputFailed{false};
+    std::exception_ptr outputError;
 };
 } // namespace wibens::tuilight
@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wibens::tuilight
+{
+
+// Work-stealing pool for fork-join style jobs: every thread works through a queue of its own and takes work from
+// the back of the others once that runs dry. The thread calling run() helps out instead of waiting idle.
+class ThreadPool
+{
+  public:
+    using Task = std::function<void(std::size_t)>;
+
+    explicit ThreadPool(std::size_t workers = std::max(std::thread::hardware_concurrency(), 1u) - 1);
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ~ThreadPool();
+
+    // Calls task(0) to task(count - 1) and returns once all of them finished, rethrowing the first exception. Runs
+    // nested in a task of the same pool execute serially on the calling thread.
+    void run(std::size_t count, const Task &task);
+    std::size_t size() const { return workers.size() + 1; }
+    // Whether the calling thread is working on a run of this pool, where further runs execute serially
+    bool inRun() const;
+
+    // Shared by all parallel containers unless they are given a pool of their own
+    static ThreadPool &shared();
+
+  private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::size_t> items;
+    };
+
+    void work(std::size_t self);
+    bool runOne(std::size_t self);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex running;
+    const Task *task = nullptr;
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    std::atomic<std::size_t> remaining{0};
+    std::atomic<std::uint32_t> generation{0};
+    std::atomic<bool> stopping{false};
+};
+
+} // namespace wibens::tuilight
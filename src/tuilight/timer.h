@@ -0,0 +1,269 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace wibens::tuilight
+{
+
+// One-shot and periodic timers on a hierarchical wheel with millisecond ticks. Level n has 64 slots that each span
+// 64^n ticks; a timer sits in the lowest level that reaches its deadline and moves down a level each time its slot
+// comes up, so adding, canceling and expiring a timer are O(1) amortized. Not thread-safe.
+template <class... Args> class TimerWheel
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void(Args...)>;
+    // Never 0, so 0 can stand for no timer
+    using Id = std::uint64_t;
+
+    explicit TimerWheel(Clock::time_point origin = Clock::now()) : origin(origin) { heads.fill(none); }
+
+    // Calls callback once delay has passed, and every interval after that unless interval is 0
+    Id add(Clock::time_point now, Clock::duration delay, Callback callback, Clock::duration interval = {})
+    {
+        std::uint32_t index;
+        if (freeList != none) {
+            index = freeList;
+            freeList = timers[index].next;
+        } else {
+            index = static_cast<std::uint32_t>(timers.size());
+            timers.emplace_back();
+        }
+        auto &timer = timers[index];
+        timer.callback = std::move(callback);
+        // Never fires early, and never in the tick that is being expired
+        timer.deadline = std::max(ceilTick(now + delay), current + 1);
+        timer.interval = interval > Clock::duration{} ? ceilTick(origin + interval) : 0;
+        link(index);
+        ++active;
+        return static_cast<Id>(timer.generation) << 32 | index;
+    }
+
+    // Returns false for timers that already fired or were canceled
+    bool cancel(Id id)
+    {
+        auto index = static_cast<std::uint32_t>(id);
+        if (index >= timers.size() || timers[index].generation != id >> 32) {
+            return false;
+        }
+        if (timers[index].slot != unlinked) {
+            unlink(index);
+        }
+        release(index);
+        return true;
+    }
+
+    std::size_t size() const { return active; }
+
+    // When the earliest timer may be due: its deadline, or the start of the slot it waits in on a higher level
+    std::optional<Clock::time_point> nextDeadline() const
+    {
+        std::optional<std::uint64_t> earliest;
+        for (std::size_t level = 0; level < levels; ++level) {
+            if (occupied[level] == 0) {
+                continue;
+            }
+            auto shift = level * slotBits;
+            auto position = current >> shift & slotMask;
+            // Distance from the current slot to the next occupied one, a full turn for the current slot itself
+            auto rotated = std::rotr(occupied[level], static_cast<int>((position + 1) & slotMask));
+            auto distance = static_cast<std::uint64_t>(std::countr_zero(rotated)) + 1;
+            auto tick = ((current >> shift) + distance) << shift;
+            earliest = earliest ? std::min(*earliest, tick) : tick;
+        }
+        if (!earliest) {
+            return std::nullopt;
+        }
+        return origin + std::chrono::milliseconds(*earliest);
+    }
+
+    // Runs every timer that is due at now and returns how many ran. Timers that fell behind by several periods run
+    // once. Callbacks may add and cancel timers, including their own.
+    std::size_t advance(Clock::time_point now, Args... args)
+    {
+        due.clear();
+        advanceTo(floorTick(now));
+        std::size_t ran = 0;
+        for (auto [index, generation] : due) {
+            if (timers[index].generation != generation) {
+                continue;
+            }
+            // Moved out, the callback may add timers and so move the slots
+            auto callback = std::move(timers[index].callback);
+            callback(args...);
+            ++ran;
+            if (timers[index].generation != generation) {
+                continue;
+            }
+            if (timers[index].slot == unlinked) {
+                release(index);
+            } else {
+                timers[index].callback = std::move(callback);
+            }
+        }
+        return ran;
+    }
+
+  private:
+    static constexpr std::size_t slotBits = 6;
+    static constexpr std::size_t slots = 1 << slotBits;
+    static constexpr std::uint64_t slotMask = slots - 1;
+    static constexpr std::size_t levels = 4;
+    static constexpr std::uint64_t span = std::uint64_t{1} << (slotBits * levels);
+    static constexpr std::uint32_t none = UINT32_MAX;
+    static constexpr std::uint16_t unlinked = UINT16_MAX;
+
+    struct Timer {
+        Callback callback;
+        std::uint64_t deadline{};
+        std::uint64_t interval{};
+        std::uint32_t generation = 1;
+        // Neighbours in the slot, next also links the free list
+        std::uint32_t prev = none;
+        std::uint32_t next = none;
+        std::uint16_t slot = unlinked;
+    };
+
+    std::uint64_t floorTick(Clock::time_point time) const
+    {
+        return std::chrono::floor<std::chrono::milliseconds>(time - origin).count();
+    }
+    std::uint64_t ceilTick(Clock::time_point time) const
+    {
+        return std::chrono::ceil<std::chrono::milliseconds>(time - origin).count();
+    }
+
+    void link(std::uint32_t index)
+    {
+        auto &timer = timers[index];
+        // Deadlines beyond the top level wait in its furthest slot and are placed again when it comes up
+        auto deadline = std::min(timer.deadline, current + span - 1);
+        auto delta = deadline - current;
+        std::size_t level = 0;
+        while (level + 1 < levels && delta >= std::uint64_t{1} << (slotBits * (level + 1))) {
+            ++level;
+        }
+        auto slot = static_cast<std::uint16_t>(level * slots + (deadline >> (level * slotBits) & slotMask));
+        timer.slot = slot;
+        timer.prev = none;
+        timer.next = heads[slot];
+        if (timer.next != none) {
+            timers[timer.next].prev = index;
+        }
+        heads[slot] = index;
+        occupied[level] |= std::uint64_t{1} << (slot & slotMask);
+    }
+
+    void unlink(std::uint32_t index)
+    {
+        auto &timer = timers[index];
+        if (timer.prev != none) {
+            timers[timer.prev].next = timer.next;
+        } else {
+            heads[timer.slot] = timer.next;
+        }
+        if (timer.next != none) {
+            timers[timer.next].prev = timer.prev;
+        }
+        if (heads[timer.slot] == none) {
+            occupied[timer.slot / slots] &= ~(std::uint64_t{1} << (timer.slot & slotMask));
+        }
+        timer.slot = unlinked;
+    }
+
+    void release(std::uint32_t index)
+    {
+        auto &timer = timers[index];
+        ++timer.generation;
+        timer.callback = nullptr;
+        timer.next = freeList;
+        freeList = index;
+        --active;
+    }
+
+    // Takes the whole list of a slot off the wheel
+    std::uint32_t take(std::size_t slot)
+    {
+        auto head = heads[slot];
+        heads[slot] = none;
+        occupied[slot / slots] &= ~(std::uint64_t{1} << (slot & slotMask));
+        return head;
+    }
+
+    // Moves the slot of level that starts at the current tick down, after the levels above it did the same
+    void cascade(std::size_t level)
+    {
+        auto position = current >> (level * slotBits) & slotMask;
+        if (position == 0 && level + 1 < levels) {
+            cascade(level + 1);
+        }
+        for (auto index = take(level * slots + position); index != none;) {
+            auto next = timers[index].next;
+            link(index);
+            index = next;
+        }
+    }
+
+    void expire()
+    {
+        for (auto index = take(current & slotMask); index != none;) {
+            auto &timer = timers[index];
+            auto next = timer.next;
+            timer.slot = unlinked;
+            due.emplace_back(index, timer.generation);
+            if (timer.interval > 0) {
+                // Periods that ended before the target are skipped, they keep their phase
+                timer.deadline += ((target - timer.deadline) / timer.interval + 1) * timer.interval;
+                link(index);
+            }
+            index = next;
+        }
+    }
+
+    void advanceTo(std::uint64_t to)
+    {
+        target = to;
+        while (current < target) {
+            // Occupied slots of the first level that come before it wraps around are jumped to directly
+            auto position = current & slotMask;
+            auto ahead = position == slotMask ? 0 : occupied[0] & (~std::uint64_t{0} << (position + 1));
+            if (ahead != 0) {
+                auto tick = (current & ~slotMask) + static_cast<std::uint64_t>(std::countr_zero(ahead));
+                if (tick > target) {
+                    break;
+                }
+                current = tick;
+                expire();
+                continue;
+            }
+            auto wrap = (current | slotMask) + 1;
+            if (wrap > target) {
+                break;
+            }
+            current = wrap;
+            cascade(1);
+            expire();
+        }
+        current = std::max(current, target);
+    }
+
+    Clock::time_point origin;
+    std::uint64_t current{};
+    // Where the running advance ends
+    std::uint64_t target{};
+    std::vector<Timer> timers;
+    std::uint32_t freeList = none;
+    std::size_t active{};
+    std::array<std::uint32_t, levels * slots> heads;
+    std::array<std::uint64_t, levels> occupied{};
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> due;
+};
+
+} // namespace wibens::tuilight
@@ -0,0 +1,45 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace wibens::tuilight
+{
+
+// Lock-free handoff of the latest value from a single producer to a single consumer. Neither side ever waits for the
+// other: the producer always has a buffer to write to, and a value the consumer did not pick up in time is replaced
+// by the next one.
+template <class T> class TripleBuffer
+{
+  public:
+    // Must only be used from the producer thread
+    T &writeBuffer() { return slots[writeIndex]; }
+    void publish()
+    {
+        auto previous = middle.exchange(writeIndex | fresh, std::memory_order_acq_rel);
+        writeIndex = previous & indexMask;
+    }
+
+    // Must only be used from the consumer thread, returns false when nothing was published since the last update
+    bool update()
+    {
+        if ((middle.load(std::memory_order_relaxed) & fresh) == 0) {
+            return false;
+        }
+        auto previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & indexMask;
+        return true;
+    }
+    const T &readBuffer() const { return slots[readIndex]; }
+
+  private:
+    static constexpr std::uint8_t indexMask = 3;
+    static constexpr std::uint8_t fresh = 4;
+
+    std::array<T, 3> slots{};
+    alignas(64) std::uint8_t writeIndex = 0;
+    alignas(64) std::atomic<std::uint8_t> middle{1};
+    alignas(64) std::uint8_t readIndex = 2;
+};
+
+} // namespace wibens::tuilight
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+namespace wibens::tuilight::unicode
+{
+
+// Vectorized check whether text needs any of the slower UTF-8 handling below
+bool isAscii(std::string_view text);
+
+// Decodes the code point at pos and advances pos past it, malformed input decodes to U+FFFD one byte at a time
+char32_t decode(std::string_view text, std::size_t &pos);
+// Writes the UTF-8 encoding of c to out, which must have room for 4 bytes, and returns the number of bytes
+std::size_t encode(char32_t c, char *out);
+
+// Number of terminal columns a code point occupies: 0 for combining marks and other zero width characters, 2 for
+// east asian wide characters and emoji, 1 otherwise
+int width(char32_t c);
+std::size_t displayWidth(std::string_view text);
+// The longest prefix of text that fits in the given number of columns without splitting a character
+std::string_view clip(std::string_view text, std::size_t columns);
+
+} // namespace wibens::tuilight::unicode
@@ -1,5 +1,5 @@
 #pragma once
-#include <optional>
+#include <cstdint>
 #include <string>
 #include <string_view>
 
@@ -25,17 +25,94 @@ enum class Color {
     BrightWhite,
 };
 
-struct Style {
-    bool bold = false;
-    bool underline = false;
-    bool blink = false;
-    bool dim = false;
-    bool invert = false;
-    bool hidden = false;
-    std::optional<Color> fgColor{};
-    std::optional<Color> bgColor{};
+// A color as the terminal knows it: its default, one of the 16 named colors, an index in the 256 color palette or a
+// 24-bit RGB value. Packed into 26 bits, the kind in the top two.
+class TermColor
+{
+  public:
+    enum class Kind : std::uint8_t { Default, Named, Palette, Rgb };
+
+    constexpr TermColor() = default;
+    constexpr TermColor(Color color) : value(pack(Kind::Named, static_cast<std::uint32_t>(color))) {}
+
+    static constexpr TermColor palette(std::uint8_t index) { return TermColor(pack(Kind::Palette, index)); }
+    static constexpr TermColor rgb(std::uint8_t red, std::uint8_t green, std::uint8_t blue)
+    {
+        return TermColor(pack(Kind::Rgb, static_cast<std::uint32_t>(red) << 16 | green << 8 | blue));
+    }
+    static constexpr TermColor fromRaw(std::uint32_t raw) { return TermColor(raw & mask); }
+
+    constexpr Kind kind() const { return static_cast<Kind>(value >> payloadBits); }
+    constexpr bool isDefault() const { return kind() == Kind::Default; }
+    constexpr Color color() const { return static_cast<Color>(value & 0xF); }
+    constexpr std::uint8_t index() const { return value & 0xFF; }
+    constexpr std::uint8_t red() const { return value >> 16 & 0xFF; }
+    constexpr std::uint8_t green() const { return value >> 8 & 0xFF; }
+    constexpr std::uint8_t blue() const { return value & 0xFF; }
+    constexpr std::uint32_t raw() const { return value; }
+
+    constexpr bool operator==(const TermColor &) const = default;
+
+    static constexpr int bits = 26;
+
+  private:
+    static constexpr int payloadBits = 24;
+    static constexpr std::uint32_t mask = (1u << bits) - 1;
+
+    constexpr explicit TermColor(std::uint32_t raw) : value(raw) {}
+    static constexpr std::uint32_t pack(Kind kind, std::uint32_t payload)
+    {
+        return static_cast<std::uint32_t>(kind) << payloadBits | payload;
+    }
+
+    std::uint32_t value{};
 };
 
+// Attributes and colors of a cell in a single 64-bit word: the foreground in bits 0-25, the background in bits 26-51
+// and the attributes from bit 52 up
+class Style
+{
+  public:
+    enum Attribute : std::uint8_t {
+        Bold = 1 << 0,
+        Underline = 1 << 1,
+        Blink = 1 << 2,
+        Dim = 1 << 3,
+        Invert = 1 << 4,
+        Hidden = 1 << 5,
+    };
+
+    constexpr Style() = default;
+
+    constexpr bool has(Attribute attribute) const { return attributes() & attribute; }
+    constexpr std::uint8_t attributes() const { return value >> attributeShift; }
+    constexpr void set(Attribute attribute, bool enable = true)
+    {
+        auto bit = static_cast<std::uint64_t>(attribute) << attributeShift;
+        value = enable ? value | bit : value & ~bit;
+    }
+    constexpr void toggle(Attribute attribute) { value ^= static_cast<std::uint64_t>(attribute) << attributeShift; }
+
+    constexpr TermColor foreground() const { return TermColor::fromRaw(value); }
+    constexpr TermColor background() const { return TermColor::fromRaw(value >> TermColor::bits); }
+    constexpr void setForeground(TermColor color) { value = (value & ~colorMask) | color.raw(); }
+    constexpr void setBackground(TermColor color)
+    {
+        value = (value & ~(colorMask << TermColor::bits)) | static_cast<std::uint64_t>(color.raw()) << TermColor::bits;
+    }
+
+    constexpr std::uint64_t raw() const { return value; }
+    constexpr bool operator==(const Style &) const = default;
+
+  private:
+    static constexpr int attributeShift = 2 * TermColor::bits;
+    static constexpr std::uint64_t colorMask = (std::uint64_t{1} << TermColor::bits) - 1;
+
+    std::uint64_t value{};
+};
+
+class Screen;
+
 class View
 {
   public:
@@ -43,6 +120,15 @@ class View
     View(std::size_t width, std::size_t height, Style style = {}) : width(width), height(height), viewStyle(style) {}
     virtual ~View() = default;
     virtual void write(std::size_t column, std::size_t row, Style style, std::string_view data) = 0;
+    // Copies the top left width x height cells of source to column, row
+    virtual void blit(std::size_t column, std::size_t row, const Screen &source, std::size_t width, std::size_t height);
+    // Sets width x height cells to c without building a string for them
+    virtual void fill(std::size_t column, std::size_t row, std::size_t width, std::size_t height, Style style,
+                      char32_t c = U' ');
+    void repeat(std::size_t column, std::size_t row, Style style, char32_t c, std::size_t count)
+    {
+        fill(column, row, count, 1, style, c);
+    }
 
     std::size_t width{};
     std::size_t height{};
@@ -56,6 +142,10 @@ class SubView : public View
     SubView(View &parent, std::size_t x, std::size_t y, std::size_t width, std::size_t height);
 
     void write(std::size_t column, std::size_t row, Style style, std::string_view data) override;
+    void blit(std::size_t column, std::size_t row, const Screen &source, std::size_t width,
+              std::size_t height) override;
+    void fill(std::size_t column, std::size_t row, std::size_t width, std::size_t height, Style style,
+              char32_t c = U' ') override;
 
     const std::size_t x;
     const std::size_t y;
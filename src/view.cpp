@@ -1,8 +1,47 @@
 #include "tuilight/view.h"
+#include "tuilight/screen.h"
+#include "tuilight/unicode.h"
+#include <algorithm>
 
 namespace wibens::tuilight
 {
 
+void View::blit(std::size_t column, std::size_t row, const Screen &source, std::size_t width, std::size_t height)
+{
+    for (std::size_t y = 0; y < height; ++y) {
+        for (std::size_t x = 0; x < width; ++x) {
+            auto cell = source.cell(x, y);
+            if (cell.character != Cell::continuation) {
+                char bytes[4];
+                write(column + x, row + y, cell.style, std::string_view(bytes, unicode::encode(cell.character, bytes)));
+            }
+        }
+    }
+}
+
+void View::fill(std::size_t column, std::size_t row, std::size_t width, std::size_t height, Style style, char32_t c)
+{
+    char bytes[4];
+    auto size = unicode::encode(c, bytes);
+    auto cells = static_cast<std::size_t>(unicode::width(c));
+    if (cells == 0 || column >= View::width) {
+        return;
+    }
+    width = std::min(width, View::width - column);
+    // Written in chunks from a buffer on the stack
+    constexpr std::size_t chunk = 64;
+    char buffer[chunk * sizeof(bytes)];
+    for (std::size_t i = 0; i < chunk; ++i) {
+        std::copy_n(bytes, size, buffer + i * size);
+    }
+    for (std::size_t y = 0; y < height; ++y) {
+        for (std::size_t x = 0; x + cells <= width; x += chunk * cells) {
+            auto count = std::min(chunk, (width - x) / cells);
+            write(column + x, row + y, style, std::string_view(buffer, count * size));
+        }
+    }
+}
+
 SubView::SubView(View &parent, std::size_t x, std::size_t y, std::size_t width, std::size_t height)
     : View(width, height, parent.viewStyle), parent(parent), x(x), y(y)
 {
@@ -11,11 +50,27 @@ SubView::SubView(View &parent, std::size_t x, std::size_t y, std::size_t width,
 void SubView::write(std::size_t column, std::size_t row, Style style, std::string_view data)
 {
     if (column < width && row < height) {
-        if (column + data.size() > width) {
-            data = data.substr(0, width - column);
-        }
+        data = unicode::clip(data, width - column);
         parent.write(column + x, row + y, style, data);
     }
 }
 
+void SubView::fill(std::size_t column, std::size_t row, std::size_t fillWidth, std::size_t fillHeight, Style style,
+                   char32_t c)
+{
+    if (column < width && row < height) {
+        parent.fill(column + x, row + y, std::min(fillWidth, width - column), std::min(fillHeight, height - row), style,
+                    c);
+    }
+}
+
+void SubView::blit(std::size_t column, std::size_t row, const Screen &source, std::size_t sourceWidth,
+                   std::size_t sourceHeight)
+{
+    if (column < width && row < height) {
+        parent.blit(column + x, row + y, source, std::min(sourceWidth, width - column),
+                    std::min(sourceHeight, height - row));
+    }
+}
+
 } // namespace wibens::tuilight
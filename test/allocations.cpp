@@ -0,0 +1,99 @@
+#include "test.h"
+#include "tuilight/debug.h"
+#include "tuilight/element.h"
+#include "tuilight/headless.h"
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+// The steady-state frames of representative trees must not touch the heap
+void allocationFreeFrames()
+{
+    if (!debug::countsAllocations) {
+        std::printf("  skipped, allocations are not counted\n");
+        return;
+    }
+    struct Tree {
+        std::string_view name;
+        BaseElement root;
+        std::function<void(HeadlessTerminal &)> change;
+    };
+    std::vector<Tree> trees;
+
+    auto text = Text("filled", true);
+    bool toggle = false;
+    trees.push_back({"frame_text_fill", Frame(text | Fit | Bold | ForegroundColor(Color::Green)),
+                     [text, toggle](HeadlessTerminal &) mutable {
+                         toggle = !toggle;
+                         text->setText(toggle ? "filled" : "FILLED");
+                     }});
+
+    std::vector<BaseElement> grid;
+    for (int r = 0; r < 10; ++r) {
+        std::vector<BaseElement> columns;
+        for (int c = 0; c < 10; ++c) {
+            columns.push_back(Button(std::to_string(r * 10 + c), [] {}) | HStretch());
+        }
+        grid.push_back(HContainer(columns));
+    }
+    bool right = true;
+    trees.push_back({"nested_grid", VContainer(grid), [right](HeadlessTerminal &t) mutable {
+                         right = !right;
+                         t.sendKey(right ? KeyEvent::RIGHT : KeyEvent::DOWN);
+                     }});
+
+    std::vector<BaseElement> rows;
+    for (int i = 0; i < 1000; ++i) {
+        rows.push_back(Selectable(Text("row " + std::to_string(i)) | Underline));
+    }
+    trees.push_back({"vmenu", VMenu(rows), [](HeadlessTerminal &t) {
+                         if (!t.sendKey(KeyEvent::PAGE_DOWN)) {
+                             t.sendKey(KeyEvent::HOME);
+                         }
+                     }});
+
+    using Column = detail::Table::Column;
+    trees.push_back({"table",
+                     Table({{"id", Column::Mode::Fixed, 8}, {"value", Column::Mode::Stretch}}, 100000,
+                           [](std::size_t row, std::size_t column) { return std::to_string(row * (column + 1)); }),
+                     [](HeadlessTerminal &t) { t.sendKey(KeyEvent::DOWN); }});
+
+    auto log = LogView(100);
+    for (int i = 0; i < 200; ++i) {
+        log->append("line " + std::to_string(i));
+    }
+    trees.push_back({"logview", log, [](HeadlessTerminal &t) { t.sendKey(KeyEvent::UP); }});
+
+    for (auto &tree : trees) {
+        HeadlessTerminal terminal(80, 24);
+        terminal.setRoot(tree.root);
+        // The first frames size the buffers that are reused afterwards
+        for (int frame = 0; frame < 3; ++frame) {
+            tree.change(terminal);
+            terminal.render();
+        }
+        std::size_t allocations{};
+        for (int frame = 0; frame < 50; ++frame) {
+            tree.change(terminal);
+            terminal.render();
+            allocations += terminal.frameAllocations();
+        }
+        if (!check(allocations == 0, tree.name)) {
+            std::fprintf(stderr, "  %zu allocations in 50 frames\n", allocations);
+        }
+    }
+}
+
+Register registered("allocation_free_frames", allocationFreeFrames);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
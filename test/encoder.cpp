@@ -0,0 +1,132 @@
+#include "test.h"
+#include "tuilight/encoder.h"
+#include "tuilight/screen.h"
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+// Applies the sequences FrameEncoder emits to a grid of characters, like a terminal would
+class MiniTerminal
+{
+  public:
+    MiniTerminal(std::size_t width, std::size_t height) : width(width), height(height), rows(height, blank()) {}
+
+    void feed(std::string_view data)
+    {
+        for (std::size_t i = 0; i < data.size();) {
+            if (data[i] != '\033') {
+                if (row < height && column < width) {
+                    rows[row][column] = data[i];
+                }
+                ++column;
+                ++i;
+                continue;
+            }
+            i += 2;
+            std::vector<std::size_t> numbers{0};
+            bool privateMode = i < data.size() && data[i] == '?';
+            for (; i < data.size() && !std::isalpha(static_cast<unsigned char>(data[i])); ++i) {
+                if (data[i] == ';') {
+                    numbers.push_back(0);
+                } else if (std::isdigit(static_cast<unsigned char>(data[i]))) {
+                    numbers.back() = numbers.back() * 10 + static_cast<std::size_t>(data[i] - '0');
+                }
+            }
+            auto final = data[i++];
+            if (privateMode) {
+                continue;
+            }
+            auto first = numbers[0];
+            if (final == 'H') {
+                row = std::max<std::size_t>(first, 1) - 1;
+                column = numbers.size() > 1 ? std::max<std::size_t>(numbers[1], 1) - 1 : 0;
+            } else if (final == 'J') {
+                std::fill(rows.begin(), rows.end(), blank());
+            } else if (final == 'r') {
+                top = first > 0 ? first - 1 : 0;
+                bottom = first > 0 ? numbers[1] : height;
+                row = column = 0;
+            } else if (final == 'S' || final == 'T') {
+                for (std::size_t n = std::max<std::size_t>(first, 1); n > 0; --n) {
+                    if (final == 'S') {
+                        rows.erase(rows.begin() + static_cast<long>(top));
+                        rows.insert(rows.begin() + static_cast<long>(bottom) - 1, blank());
+                    } else {
+                        rows.erase(rows.begin() + static_cast<long>(bottom) - 1);
+                        rows.insert(rows.begin() + static_cast<long>(top), blank());
+                    }
+                }
+            }
+        }
+    }
+    const std::string &line(std::size_t index) const { return rows[index]; }
+
+  private:
+    std::string blank() const { return std::string(width, ' '); }
+
+    std::size_t width;
+    std::size_t height;
+    std::vector<std::string> rows;
+    std::size_t row{};
+    std::size_t column{};
+    std::size_t top{};
+    std::size_t bottom = height;
+};
+
+void frameEncoderScroll()
+{
+    constexpr std::size_t width = 40;
+    constexpr std::size_t height = 20;
+    Capture capture;
+    auto encode = [&](FrameEncoder &encoder, const Screen &screen) {
+        encoder.encode(screen, capture.out());
+        return capture.take();
+    };
+    auto draw = [](Screen &screen, std::size_t first, std::size_t top, std::size_t bottom) {
+        screen.clear();
+        screen.write(0, 0, {}, "header");
+        for (auto row = top; row < bottom; ++row) {
+            screen.write(0, row, {}, "line " + std::to_string(first + row) + " of the log");
+        }
+    };
+
+    // A region below a fixed header scrolls by a few lines in either direction
+    Screen screen(width, height);
+    FrameEncoder encoder;
+    MiniTerminal terminal(width, height);
+    std::size_t first = 100;
+    std::size_t scrolls{};
+    for (int shift : {1, 1, 3, -2, 5, -1, 0, 4}) {
+        first += static_cast<std::size_t>(shift);
+        draw(screen, first, 1, height - 1);
+        auto data = encode(encoder, screen);
+        scrolls += data.find('S') != std::string::npos || data.find('T') != std::string::npos;
+        terminal.feed(data);
+        for (std::size_t row = 0; row < height; ++row) {
+            std::string expected;
+            for (std::size_t column = 0; column < width; ++column) {
+                expected += static_cast<char>(screen.glyph(column, row));
+            }
+            check(terminal.line(row) == expected, "terminal shows the frame");
+        }
+    }
+    check(scrolls >= 6, "shifted rows are scrolled instead of redrawn");
+
+    // Scrolling by one line only sends the line that came in
+    draw(screen, first + 1, 1, height - 1);
+    check(encode(encoder, screen).size() < 100, "a one line scroll is cheap");
+}
+
+Register frameEncoderScrollTest("frame_encoder_scroll", frameEncoderScroll);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
@@ -0,0 +1,142 @@
+#include "test.h"
+#include "tuilight/element.h"
+#include "tuilight/index.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+// Compared with summing up a plain list of heights
+void heightIndex()
+{
+    std::mt19937 rng(1);
+    for (std::size_t defaultHeight : {1, 2}) {
+        HeightIndex index(defaultHeight);
+        std::vector<std::size_t> heights;
+        auto offset = [&](std::size_t row) {
+            std::size_t sum{};
+            for (std::size_t i = 0; i < row; ++i) {
+                sum += heights[i];
+            }
+            return sum;
+        };
+        for (int step = 0; step < 2000; ++step) {
+            if (rng() % 10 == 0) {
+                heights.resize(rng() % 100, defaultHeight);
+                index.resize(heights.size());
+            } else if (!heights.empty()) {
+                auto row = rng() % heights.size();
+                heights[row] = rng() % 4;
+                index.set(row, heights[row]);
+            }
+            check(index.size() == heights.size() && index.total() == offset(heights.size()), "total");
+            for (int probe = 0; probe < 5 && !heights.empty(); ++probe) {
+                auto row = rng() % (heights.size() + 1);
+                check(index.offset(row) == offset(row), "offset");
+                // The last row that starts at or before the target
+                auto target = rng() % (offset(heights.size()) + 3);
+                std::size_t expected{};
+                while (expected + 1 < heights.size() && offset(expected + 1) <= target) {
+                    ++expected;
+                }
+                check(index.find(target) == expected, "find");
+            }
+        }
+    }
+}
+
+Register heightIndexTest("height_index", heightIndex);
+
+// Compared with counting and searching a plain list of flags
+void focusIndex()
+{
+    std::mt19937 rng(2);
+    for (bool defaultFocusable : {false, true}) {
+        FocusIndex index(defaultFocusable);
+        std::vector<bool> focusable;
+        for (int step = 0; step < 3000; ++step) {
+            switch (rng() % 5) {
+                case 0:
+                    focusable.resize(rng() % 80, defaultFocusable);
+                    index.resize(focusable.size());
+                    break;
+                case 1: {
+                    auto at = rng() % (focusable.size() + 1);
+                    bool value = rng() % 2;
+                    focusable.insert(focusable.begin() + static_cast<long>(at), value);
+                    index.insert(at, value);
+                    break;
+                }
+                case 2:
+                    if (!focusable.empty()) {
+                        auto at = rng() % focusable.size();
+                        focusable.erase(focusable.begin() + static_cast<long>(at));
+                        index.erase(at);
+                    }
+                    break;
+                default:
+                    if (!focusable.empty()) {
+                        auto at = rng() % focusable.size();
+                        focusable[at] = rng() % 2;
+                        index.set(at, focusable[at]);
+                    }
+                    break;
+            }
+            auto count = static_cast<std::size_t>(std::count(focusable.begin(), focusable.end(), true));
+            check(index.size() == focusable.size() && index.count() == count, "count");
+            for (int probe = 0; probe < 5; ++probe) {
+                auto at = rng() % (focusable.size() + 1);
+                auto rank = static_cast<std::size_t>(std::count(focusable.begin(), focusable.begin() + at, true));
+                check(index.rank(at) == rank, "rank");
+                if (rank < count) {
+                    check(index.select(rank) == static_cast<std::size_t>(
+                                                    std::find(focusable.begin() + at, focusable.end(), true) -
+                                                    focusable.begin()),
+                          "select");
+                }
+                auto next = std::find(focusable.begin() + at, focusable.end(), true);
+                check(index.next(at) == (next == focusable.end() ? FocusIndex::none
+                                                                 : static_cast<std::size_t>(next - focusable.begin())),
+                      "next");
+                auto prev = FocusIndex::none;
+                for (std::size_t i = 0; i < at; ++i) {
+                    prev = focusable[i] ? i : prev;
+                }
+                check(index.prev(at) == prev, "prev");
+                if (at < focusable.size()) {
+                    check(index.focusable(at) == focusable[at], "focusable");
+                }
+            }
+        }
+    }
+}
+
+Register focusIndexTest("focus_index", focusIndex);
+
+// A container keeps the focus on the same child while others come and go
+void containerFocus()
+{
+    auto first = Button("first", [] {});
+    auto last = Button("last", [] {});
+    auto container = VContainer(first, Text("text"), last);
+    container->setFocus(true);
+    check(container->focusedIndex() == 0 && container->focusedChild() == BaseElement(first), "starts on the first");
+    container->focusChild(2);
+    container->insert(0, Text("above"));
+    check(container->focusedIndex() == 3 && container->focusedChild() == BaseElement(last), "follows an insert");
+    container->remove(3);
+    check(container->children().size() == 3 && container->focusedChild() == BaseElement(first),
+          "falls back to the previous focusable child");
+    check(first->isFocused() && !last->isFocused(), "and focuses it");
+}
+
+Register containerFocusTest("container_focus", containerFocus);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
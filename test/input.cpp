@@ -0,0 +1,56 @@
+#include "test.h"
+#include "tuilight/input.h"
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+using ansi::KeyEvent;
+
+// Sequences may be split anywhere between reads, events only come out once they are complete
+void inputParser()
+{
+    InputParser parser;
+    std::vector<InputEvent> events;
+    auto feed = [&](std::initializer_list<std::string_view> chunks) {
+        events.clear();
+        for (auto chunk : chunks) {
+            parser.feed(chunk, events);
+        }
+        std::vector<KeyEvent> keys;
+        for (auto &event : events) {
+            keys.push_back(event.key);
+        }
+        return keys;
+    };
+    using Keys = std::vector<KeyEvent>;
+
+    check(feed({"\033[A\033OPx"}) == Keys{KeyEvent::UP, KeyEvent::F1, ansi::CharEvent('x')}, "whole sequences");
+    parser.feed("\033[", events);
+    check(parser.pending(), "pending CSI");
+    check(feed({"6~"}) == Keys{KeyEvent::PAGE_DOWN}, "CSI split after the introducer");
+    check(feed({"\033", "[1;5", "C"}) == Keys{KeyEvent::RIGHT | ansi::KeyModifier::CTRL}, "CSI split in parameters");
+    check(feed({"\033", "O", "Q"}) == Keys{KeyEvent::F2}, "SS3 split");
+
+    check(feed({"\033[20", "0~hel", "lo\033[2", "01", "~z"}) == Keys{KeyEvent::PASTE, ansi::CharEvent('z')},
+          "paste split across markers");
+    check(events.size() == 2 && events[0].text == "hello", "pasted text");
+    check(feed({"\033[200~a\033[A\033", "[201~"}) == Keys{KeyEvent::PASTE} && events[0].text == "a\033[A",
+          "escape sequences inside a paste");
+
+    events.clear();
+    parser.feed("\033", events);
+    check(events.empty() && parser.pending(), "lone ESC waits");
+    parser.timeout(events);
+    check(events.size() == 1 && events[0].key == KeyEvent::ESCAPE && !parser.pending(), "ESC after the timeout");
+}
+
+Register inputParserTest("input_parser", inputParser);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
@@ -0,0 +1,66 @@
+#include "test.h"
+#include "tuilight/element.h"
+#include "tuilight/headless.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+struct Chain {
+    std::string name;
+    std::function<BaseElement()> piped;
+    std::function<BaseElement()> nested;
+};
+
+bool sameSize(ElementSize a, ElementSize b)
+{
+    return a.minWidth == b.minWidth && a.minHeight == b.minHeight && a.maxWidth == b.maxWidth &&
+           a.maxHeight == b.maxHeight;
+}
+
+// Layers piped into one Fused node must size and draw like the same layers wrapped around each other one by one
+void fusedMatchesNested()
+{
+    std::vector<Chain> chains{
+        {"style and size",
+         [] { return Text("hello") | Bold | ForegroundColor(Color::Red) | Stretch() | Limit(12, 1); },
+         [] { return Limit(12, 1)(Stretch()(ForegroundColor(Color::Red)(Bold(Text("hello"))))); }},
+        {"toggles",
+         [] { return Text("toggled", true) | Invert | BackgroundColor(Color::Green) | Invert | Shrink(3, 1); },
+         [] { return Shrink(3, 1)(Invert(BackgroundColor(Color::Green)(Invert(Text("toggled", true))))); }},
+        // Center is no layer and ends the chain
+        {"ended by a decorator",
+         [] { return Frame(Text("boxed")) | HStretch() | Dim | Limit(9, 4) | Underline | Center; },
+         [] { return Center(Underline(Limit(9, 4)(Dim(HStretch()(Frame(Text("boxed"))))))); }},
+    };
+    for (const auto &chain : chains) {
+        auto piped = chain.piped();
+        auto nested = chain.nested();
+        check(sameSize(piped->getSize(), nested->getSize()), chain.name + " size");
+        for (auto [width, height] : {std::pair<std::size_t, std::size_t>{40, 6}, {11, 3}, {4, 2}}) {
+            HeadlessTerminal expected(width, height);
+            HeadlessTerminal actual(width, height);
+            // The neighbour only gets what the layers leave over
+            expected.render(HContainer(nested, Text("|rest") | Stretch()));
+            actual.render(HContainer(piped, Text("|rest") | Stretch()));
+            bool same = true;
+            for (std::size_t row = 0; row < height && same; ++row) {
+                for (std::size_t column = 0; column < width && same; ++column) {
+                    same = expected.cell(column, row) == actual.cell(column, row);
+                }
+            }
+            check(same, chain.name + " at " + std::to_string(width) + "x" + std::to_string(height));
+        }
+    }
+}
+
+Register fusedTest("fused_matches_nested", fusedMatchesNested);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
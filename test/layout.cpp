@@ -0,0 +1,44 @@
+#include "test.h"
+#include "tuilight/element.h"
+#include "tuilight/headless.h"
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+// Sizes are cached, changing a leaf has to reach every element that contains it
+void sizeCacheInvalidation()
+{
+    auto label = Text("ab");
+    auto shared = Text("x");
+    auto left = Frame(HContainer(label, Text("cd")));
+    auto right = VContainer(shared, Text("y"));
+    auto root = VContainer(left, right, Frame(shared | Bold));
+    check(root->getSize().minWidth == 6 && root->getSize().minHeight == 8, "initial size");
+
+    label->setText("abcdef");
+    check(left->getSize().minWidth == 10 && root->getSize().minWidth == 10, "a longer text widens its ancestors");
+    check(label->text() == "abcdef", "text()");
+    label->setText("世界");
+    check(left->getSize().minWidth == 8, "measured by display width");
+
+    // Shared by two parents, both have to notice
+    shared->setText("wider than the rest");
+    check(right->getSize().minWidth == 19, "the first parent of a shared element");
+    check(root->getSize().minWidth == 21, "the second parent of a shared element");
+
+    HeadlessTerminal terminal(30, 10);
+    terminal.setRoot(root);
+    terminal.render();
+    label->setText("changed");
+    terminal.render();
+    check(terminal.rowText(1).starts_with("|changedcd"), "the next frame lays out the new text");
+}
+
+Register sizeCacheTest("size_cache_invalidation", sizeCacheInvalidation);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
@@ -0,0 +1,90 @@
+#include "test.h"
+#include "tuilight/element.h"
+#include "tuilight/headless.h"
+#include <string>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+std::string line(std::size_t index) { return "line " + std::to_string(index); }
+
+bool shows(const HeadlessTerminal &terminal, std::size_t first)
+{
+    for (std::size_t row = 0; row < terminal.height; ++row) {
+        if (!terminal.rowText(row).starts_with(line(first + row) + " ")) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The ring keeps the newest lines, the view follows them until it is scrolled up
+void logViewRing()
+{
+    auto log = LogView(5);
+    HeadlessTerminal terminal(20, 3);
+    terminal.setRoot(log);
+    for (std::size_t i = 0; i < 12; ++i) {
+        log->append(line(i));
+    }
+    terminal.render();
+    check(log->size() == 5 && log->following() && shows(terminal, 9), "the newest lines of an overflowing ring");
+
+    check(log->handleEvent(KeyEvent::UP), "scroll up");
+    terminal.render();
+    check(!log->following() && shows(terminal, 8), "scrolling up stops following");
+    log->append(line(12));
+    terminal.render();
+    check(shows(terminal, 8), "new lines do not move a view that was scrolled up");
+    check(!log->handleEvent(KeyEvent::UP) && !log->handleEvent(KeyEvent::PAGE_UP), "nothing above the oldest line");
+    terminal.render();
+    check(shows(terminal, 8), "the oldest stored line is the limit");
+
+    // More lines in one batch than the ring holds
+    for (std::size_t i = 13; i < 40; ++i) {
+        log->append(line(i));
+    }
+    terminal.render();
+    check(log->size() == 5 && shows(terminal, 35), "a scrolled view is clamped to the lines that are left");
+    check(log->handleEvent(KeyEvent::DOWN) && log->handleEvent(KeyEvent::DOWN), "scroll down");
+    check(log->following(), "reaching the bottom follows again");
+    check(!log->handleEvent(KeyEvent::DOWN) && !log->handleEvent(KeyEvent::PAGE_DOWN), "nothing below the newest line");
+    log->append(line(40));
+    terminal.render();
+    check(shows(terminal, 38), "follows new lines");
+
+    log->clear();
+    terminal.render();
+    check(log->size() == 0 && terminal.rowText(0).starts_with("   "), "cleared");
+}
+
+// At either end the keys are left to the parent, so a log does not keep the focus from its siblings
+void logViewFocus()
+{
+    bool pressed = false;
+    auto log = LogView(100);
+    for (std::size_t i = 0; i < 10; ++i) {
+        log->append(line(i));
+    }
+    auto root = VContainer(log | VStretch(), Button("below", [&pressed] { pressed = true; }));
+    HeadlessTerminal terminal(20, 6);
+    terminal.setRoot(root);
+    terminal.render();
+    check(log->isFocused(), "the log starts with the focus");
+    for (int i = 0; i < 3 && log->isFocused(); ++i) {
+        terminal.sendKey(KeyEvent::DOWN);
+    }
+    check(!log->isFocused() && terminal.sendKey(KeyEvent::RETURN) && pressed, "down moves on to the button");
+    check(root->handleEvent(KeyEvent::UP) && log->isFocused(), "and up back to the log");
+    check(root->handleEvent(KeyEvent::UP) && log->isFocused() && !log->following(), "up scrolls the log");
+}
+
+Register logViewRingTest("logview_ring", logViewRing);
+Register logViewFocusTest("logview_focus", logViewFocus);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
@@ -0,0 +1,81 @@
+#include "test.h"
+#include <cstdio>
+#include <stdexcept>
+#include <unistd.h>
+#include <string_view>
+#include <vector>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+struct Test {
+    std::string_view name;
+    void (*run)();
+};
+
+// Filled during static initialization, so it must not be a namespace scope object itself
+std::vector<Test> &tests()
+{
+    static std::vector<Test> registered;
+    return registered;
+}
+
+std::size_t failures = 0;
+} // namespace
+
+bool check(bool condition, std::string_view what, std::source_location location)
+{
+    if (!condition) {
+        std::fprintf(stderr, "%s:%u: check failed: %.*s\n", location.file_name(), location.line(),
+                     static_cast<int>(what.size()), what.data());
+        ++failures;
+    }
+    return condition;
+}
+
+Register::Register(std::string_view name, void (*run)()) { tests().push_back({name, run}); }
+
+Capture::Capture() : file(std::tmpfile()), buffer(file != nullptr ? fileno(file) : -1)
+{
+    if (file == nullptr) {
+        throw std::runtime_error("tmpfile failed");
+    }
+}
+
+Capture::~Capture() { std::fclose(file); }
+
+std::string Capture::take()
+{
+    buffer.flush();
+    auto fd = fileno(file);
+    std::string data(static_cast<std::size_t>(::lseek(fd, 0, SEEK_CUR)), '\0');
+    if (::pread(fd, data.data(), data.size(), 0) != static_cast<ssize_t>(data.size()) || ::ftruncate(fd, 0) != 0 ||
+        ::lseek(fd, 0, SEEK_SET) != 0) {
+        throw std::runtime_error("reading the capture back failed");
+    }
+    return data;
+}
+
+} // namespace wibens::tuilight::test
+
+using namespace wibens::tuilight::test;
+
+// Runs every test whose name contains the filter, exits with 1 when any check failed
+int main(int argc, char **argv)
+{
+    std::string_view filter = argc > 1 ? argv[1] : "";
+    for (const auto &test : tests()) {
+        if (test.name.find(filter) == std::string_view::npos) {
+            continue;
+        }
+        auto before = failures;
+        std::printf("%.*s\n", static_cast<int>(test.name.size()), test.name.data());
+        test.run();
+        if (failures != before) {
+            std::printf("  FAILED\n");
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
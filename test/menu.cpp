@@ -0,0 +1,50 @@
+#include "test.h"
+#include "tuilight/element.h"
+#include "tuilight/headless.h"
+#include <string>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+bool highlighted(const HeadlessTerminal &terminal, std::size_t row)
+{
+    return terminal.cell(0, row).style.has(Style::Invert);
+}
+
+// Rows of a virtual menu are only known once built, the focus must still start on the first focusable one
+void virtualMenuFocus()
+{
+    auto menu = VMenu(100, [](std::size_t i) -> BaseElement {
+        if (i == 0 || i == 3) {
+            return Text("header " + std::to_string(i));
+        }
+        return Selectable(Text("row " + std::to_string(i)));
+    });
+    HeadlessTerminal terminal(20, 10);
+    terminal.setRoot(menu);
+    terminal.render();
+    check(!highlighted(terminal, 0) && highlighted(terminal, 1), "the first focusable row is highlighted");
+    check(menu->focusedChild()->isFocused(), "and focused");
+
+    check(terminal.sendKey(KeyEvent::DOWN), "down");
+    check(terminal.sendKey(KeyEvent::DOWN), "down over the second header");
+    terminal.render();
+    check(highlighted(terminal, 4) && !highlighted(terminal, 1), "skips rows that are not focusable");
+    check(terminal.sendKey(KeyEvent::HOME), "home");
+    check(!menu->handleEvent(KeyEvent::UP), "nothing focusable above the first focusable row");
+
+    auto headers = VMenu(5, [](std::size_t i) { return Text("header " + std::to_string(i)); });
+    HeadlessTerminal other(20, 10);
+    other.setRoot(headers);
+    other.render();
+    check(!headers->focusable() && !highlighted(other, 0), "a menu whose rows turn out not to be focusable");
+}
+
+Register virtualMenuTest("virtual_menu_focus", virtualMenuFocus);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
@@ -0,0 +1,88 @@
+#include "test.h"
+#include "tuilight/element.h"
+#include "tuilight/headless.h"
+#include "tuilight/threadpool.h"
+#include <string>
+#include <vector>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+// A grid of scrolling tables and styled text, with parallel rows nested in a parallel column when parallel is set
+struct Dashboard {
+    Dashboard(bool parallel, ThreadPool &pool)
+    {
+        using Column = detail::Table::Column;
+        auto container = [&](const std::vector<BaseElement> &children, bool horizontal) -> BaseElement {
+            if (parallel) {
+                return horizontal ? BaseElement(ParallelHContainer(children, pool))
+                                  : BaseElement(ParallelVContainer(children, pool));
+            }
+            return horizontal ? BaseElement(HContainer(children)) : BaseElement(VContainer(children));
+        };
+        std::vector<BaseElement> rows;
+        for (std::size_t row = 0; row < 3; ++row) {
+            std::vector<BaseElement> panels;
+            for (std::size_t column = 0; column < 3; ++column) {
+                auto table = Table({{"key"}, {"value", Column::Mode::Stretch}}, 1000,
+                                   [row](std::size_t i, std::size_t c) {
+                                       return std::to_string(row) + ":" + std::to_string(i * (c + 7));
+                                   });
+                table->setFocus(column == row);
+                tables.push_back(table);
+                auto color = TermColor::palette(static_cast<std::uint8_t>(row * 3 + column));
+                panels.push_back(Frame(table | Stretch()) | Stretch() | ForegroundColor(color));
+            }
+            panels.push_back(Text("side " + std::to_string(row), true) | Bold | Stretch());
+            rows.push_back(Stretch()(container(panels, true)));
+        }
+        // Too small for the pool, drawn in place either way
+        rows.push_back(container({Text("a"), Text("b") | Underline}, true));
+        root = BackgroundColor(Color::Blue)(container(rows, false));
+    }
+
+    std::vector<Element<detail::Table>> tables;
+    BaseElement root;
+};
+
+// Drawing the children on the pool must give the same cells as drawing them one after another
+void parallelMatchesSequential()
+{
+    ThreadPool pool(3);
+    Dashboard sequential(false, pool);
+    Dashboard parallel(true, pool);
+    HeadlessTerminal expected(150, 45);
+    HeadlessTerminal actual(150, 45);
+    for (int frame = 0; frame < 30; ++frame) {
+        if (frame == 20) {
+            // Other sizes reshape the panels
+            expected.resize(97, 31);
+            actual.resize(97, 31);
+        }
+        for (std::size_t i = 0; i < sequential.tables.size(); ++i) {
+            auto key = (frame + i) % 3 == 0 ? KeyEvent::PAGE_DOWN : KeyEvent::DOWN;
+            sequential.tables[i]->handleEvent(key);
+            parallel.tables[i]->handleEvent(key);
+        }
+        expected.render(sequential.root);
+        actual.render(parallel.root);
+        bool same = true;
+        for (std::size_t row = 0; row < expected.height && same; ++row) {
+            for (std::size_t column = 0; column < expected.width && same; ++column) {
+                same = expected.cell(column, row) == actual.cell(column, row);
+            }
+        }
+        if (!check(same, "parallel output equals sequential output")) {
+            return;
+        }
+    }
+}
+
+Register parallelTest("parallel_matches_sequential", parallelMatchesSequential);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
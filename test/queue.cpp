@@ -0,0 +1,74 @@
+#include "test.h"
+#include "tuilight/queue.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+void boundedQueue()
+{
+    BoundedQueue<std::string> queue(5);
+    std::string value;
+    check(queue.capacity() == 8, "capacity is rounded up to a power of two");
+    check(!queue.pop(value) && queue.size() == 0, "empty");
+
+    // Wraps around the slots a few times
+    for (int round = 0; round < 3; ++round) {
+        for (std::size_t i = 0; i < queue.capacity(); ++i) {
+            check(queue.push(std::to_string(i)), "push until full");
+        }
+        check(!queue.push("overflow"), "full");
+        check(queue.size() == queue.capacity(), "size when full");
+        for (std::size_t i = 0; i < queue.capacity(); ++i) {
+            check(queue.pop(value) && value == std::to_string(i), "popped in order");
+        }
+        check(!queue.pop(value), "empty again");
+        check(queue.push("again") && queue.pop(value) && value == "again", "usable after running empty");
+    }
+
+    // Every item arrives exactly once and the items of each producer stay in order
+    constexpr int producers = 4;
+    constexpr int items = 20000;
+    BoundedQueue<int> shared(64);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&shared, p] {
+            for (int i = 0; i < items; ++i) {
+                while (!shared.push(p * items + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::vector<int> next(producers, 0);
+    int received = 0;
+    bool ordered = true;
+    while (received < producers * items) {
+        int item;
+        if (!shared.pop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        auto producer = item / items;
+        ordered = ordered && item % items == next[producer];
+        next[producer] = item % items + 1;
+        ++received;
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    int item;
+    check(ordered, "each producer's items arrive in order");
+    check(!shared.pop(item), "nothing is left over");
+}
+
+Register boundedQueueTest("bounded_queue", boundedQueue);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
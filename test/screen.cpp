@@ -0,0 +1,92 @@
+#include "test.h"
+#include "tuilight/screen.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+// The same diff one cell at a time, as the scalar tail of diffRow does it
+std::vector<Run> referenceDiff(const Screen &next, const Screen &shown, std::size_t row, std::size_t mergeGap)
+{
+    std::vector<Run> runs;
+    for (std::size_t column = 0; column < next.width; ++column) {
+        if (next.cell(column, row) == shown.cell(column, row)) {
+            continue;
+        }
+        if (!runs.empty() && column <= runs.back().end + mergeGap) {
+            runs.back().end = column + 1;
+        } else {
+            runs.push_back({column, column + 1});
+        }
+    }
+    return runs;
+}
+
+// The vectorized comparison against the reference, over every width around the vector sizes and changes to each part
+// of a style: the foreground in the lower half of its 64 bits, the background across both and the attributes on top
+void diffRowMatchesScalar()
+{
+#if defined(__AVX2__)
+    std::printf("  avx2\n");
+#elif defined(__SSE2__)
+    std::printf("  sse2\n");
+#else
+    std::printf("  scalar only\n");
+#endif
+    std::mt19937 rng(4);
+    auto randomStyle = [&] {
+        Style style;
+        switch (rng() % 4) {
+            case 0:
+                style.setForeground(TermColor::rgb(rng() % 256, rng() % 256, rng() % 256));
+                break;
+            case 1:
+                style.setBackground(TermColor::palette(rng() % 256));
+                break;
+            case 2:
+                style.set(Style::Underline);
+                break;
+            default:
+                break;
+        }
+        return style;
+    };
+    for (std::size_t width = 1; width <= 70; ++width) {
+        for (int round = 0; round < 20; ++round) {
+            Screen shown(width, 2);
+            shown.fill(0, 0, width, 2, randomStyle(), U'a' + rng() % 3);
+            auto next = shown;
+            for (auto changes = rng() % 6; changes > 0; --changes) {
+                auto column = rng() % width;
+                auto style = rng() % 2 ? randomStyle() : next.style(column, 1);
+                next.fill(column, 1, 1, 1, style, rng() % 2 ? U'a' + rng() % 3 : next.glyph(column, 1));
+            }
+            for (std::size_t gap = 0; gap < 4; ++gap) {
+                for (std::size_t row = 0; row < 2; ++row) {
+                    std::vector<Run> runs;
+                    diffRow(next, shown, row, gap, runs);
+                    auto expected = referenceDiff(next, shown, row, gap);
+                    bool same = runs.size() == expected.size();
+                    for (std::size_t i = 0; same && i < runs.size(); ++i) {
+                        same = runs[i].begin == expected[i].begin && runs[i].end == expected[i].end;
+                    }
+                    if (!check(same, "diffRow")) {
+                        std::fprintf(stderr, "  width %zu, merge gap %zu\n", width, gap);
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
+Register diffRowTest("diff_row", diffRowMatchesScalar);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
@@ -0,0 +1,86 @@
+#include "test.h"
+#include "tuilight/sgr.h"
+#include <initializer_list>
+#include <string>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+Style style(std::initializer_list<Style::Attribute> attributes, TermColor foreground = {}, TermColor background = {})
+{
+    Style result;
+    for (auto attribute : attributes) {
+        result.set(attribute);
+    }
+    result.setForeground(foreground);
+    result.setBackground(background);
+    return result;
+}
+
+// Each style is only sent as the change from the previous one, unless a full reset is shorter
+void sgrDeltas()
+{
+    Capture capture;
+    SgrEncoder encoder;
+    auto encode = [&](Style next) {
+        encoder.encode(next, capture.out());
+        return capture.take();
+    };
+
+    check(encode({}) == "\033[0m", "the first style is sent in full");
+    check(encode({}).empty(), "an unchanged style sends nothing");
+    check(encode(style({Style::Bold})) == "\033[1m", "an attribute that turns on");
+    check(encode(style({Style::Bold, Style::Underline}, Color::Red)) == "\033[4;31m", "only what was added");
+    check(encode(style({Style::Underline}, Color::Red)) == "\033[22m", "bold turns off");
+    check(encode(style({Style::Underline}, Color::Green, Color::Blue)) == "\033[32;44m", "colors change");
+    check(encode(style({Style::Underline}, {}, Color::Blue)) == "\033[39m", "back to the default foreground");
+    check(encode(style({Style::Bold, Style::Dim}, Color::BrightCyan, Color::Blue)) == "\033[24;1;2;96m",
+          "attributes turn off and on in one sequence");
+    check(encode(style({}, Color::Gray)) == "\033[0;90m", "a reset is shorter than turning everything off");
+
+    encoder.reset();
+    check(encode(style({}, Color::Gray)) == "\033[0;90m", "after reset() the style is sent in full again");
+}
+
+// Palette colors are sent as 38;5;n and RGB colors as 38;2;r;g;b, 48 for the background
+void sgrExtendedColors()
+{
+    Capture capture;
+    SgrEncoder encoder;
+    auto encode = [&](Style next) {
+        encoder.encode(next, capture.out());
+        return capture.take();
+    };
+
+    check(encode(style({}, TermColor::palette(208))) == "\033[0;38;5;208m", "palette foreground");
+    check(encode(style({}, TermColor::palette(208), TermColor::palette(17))) == "\033[48;5;17m", "palette background");
+    check(encode(style({}, TermColor::rgb(255, 128, 0), TermColor::palette(17))) == "\033[38;2;255;128;0m",
+          "rgb foreground");
+    check(encode(style({}, TermColor::rgb(255, 128, 0), TermColor::rgb(0, 0, 1))) == "\033[48;2;0;0;1m",
+          "rgb background");
+    check(encode(style({Style::Bold}, TermColor::rgb(255, 128, 0), TermColor::rgb(0, 0, 1))) == "\033[1m",
+          "an attribute next to rgb colors");
+    check(encode(style({Style::Bold}, Color::Red, TermColor::rgb(0, 0, 1))) == "\033[31m", "back to a named color");
+    check(encode(style({}, TermColor::palette(1))) == "\033[0;38;5;1m", "a palette index is not a named color");
+
+    // The colors and attributes packed into a Style do not overlap
+    Style packed;
+    packed.setForeground(TermColor::rgb(255, 255, 255));
+    packed.setBackground(TermColor::rgb(1, 2, 3));
+    packed.set(Style::Hidden);
+    packed.set(Style::Bold);
+    packed.setForeground(TermColor::palette(255));
+    check(packed.foreground() == TermColor::palette(255) && packed.background() == TermColor::rgb(1, 2, 3) &&
+              packed.has(Style::Hidden) && packed.has(Style::Bold) && !packed.has(Style::Dim),
+          "packed fields");
+}
+
+Register sgrDeltaTest("sgr_deltas", sgrDeltas);
+Register sgrExtendedColorTest("sgr_extended_colors", sgrExtendedColors);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
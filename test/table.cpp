@@ -0,0 +1,79 @@
+#include "test.h"
+#include "tuilight/element.h"
+#include "tuilight/headless.h"
+#include <string>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+using Column = detail::Table::Column;
+
+// Paging moves the selection by the rows on screen, which keep it in view while only the visible cells are built
+void tablePaging()
+{
+    std::size_t provided{};
+    auto table = Table({{"row", Column::Mode::Fixed, 8}, {"double", Column::Mode::Stretch}}, 1000000,
+                       [&provided](std::size_t row, std::size_t column) {
+                           ++provided;
+                           return std::to_string(row * (column + 1));
+                       });
+    // A header and ten rows
+    HeadlessTerminal terminal(30, 11);
+    terminal.setRoot(table);
+    terminal.render();
+    auto selectedRow = [&] {
+        for (std::size_t row = 1; row < terminal.height; ++row) {
+            if (terminal.cell(0, row).style.has(Style::Invert)) {
+                return terminal.rowText(row).substr(0, 8);
+            }
+        }
+        return std::string("none");
+    };
+    check(selectedRow() == "0       ", "the first row starts selected");
+
+    for (int i = 0; i < 3; ++i) {
+        check(table->handleEvent(KeyEvent::PAGE_DOWN), "page down");
+    }
+    provided = 0;
+    terminal.render();
+    check(table->selectedRow() == 30 && selectedRow() == "30      ", "three pages down");
+    check(terminal.rowText(10).starts_with("30 "), "the selection is the last row in view");
+    check(provided == 20, "only the visible cells are asked for");
+
+    check(table->handleEvent(KeyEvent::PAGE_UP), "page up");
+    terminal.render();
+    check(table->selectedRow() == 20 && terminal.rowText(1).starts_with("20 "),
+          "the selection is the first row in view");
+
+    check(table->handleEvent(KeyEvent::END), "end");
+    terminal.render();
+    check(selectedRow() == "999999  " && terminal.rowText(10).starts_with("999999 "), "end");
+    check(table->handleEvent(KeyEvent::PAGE_DOWN) && table->selectedRow() == 999999, "paging stops at the last row");
+    check(!table->handleEvent(KeyEvent::DOWN), "nothing below the last row");
+    check(table->handleEvent(KeyEvent::HOME) && table->handleEvent(KeyEvent::PAGE_UP) && table->selectedRow() == 0,
+          "paging stops at the first row");
+    check(!table->handleEvent(KeyEvent::UP), "nothing above the first row");
+
+    // Removing rows keeps the selection on a row that exists
+    check(table->handleEvent(KeyEvent::END), "end again");
+    table->setRowCount(15);
+    terminal.render();
+    check(table->selectedRow() < 15 && terminal.rowText(10).starts_with("14 "), "fewer rows");
+
+    table->setRowCount(0);
+    terminal.render();
+    for (auto key : {KeyEvent::UP, KeyEvent::DOWN, KeyEvent::PAGE_UP, KeyEvent::PAGE_DOWN, KeyEvent::HOME,
+                     KeyEvent::END}) {
+        check(!table->handleEvent(key), "row keys are not handled without rows");
+    }
+    check(table->selectedRow() == 0, "an empty table selects nothing past its end");
+}
+
+Register tablePagingTest("table_paging", tablePaging);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
@@ -0,0 +1,120 @@
+#include "test.h"
+#include "tuilight/element.h"
+#include "tuilight/terminal.h"
+#include <chrono>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/ioctl.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+// A pseudo terminal for Terminal to write to, with stdin swapped for /dev/null while it exists
+class Pty
+{
+  public:
+    Pty()
+    {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+            throw std::system_error(errno, std::generic_category(), "posix_openpt failed");
+        }
+        slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+        struct winsize size {};
+        size.ws_row = 5;
+        size.ws_col = 20;
+        ioctl(master, TIOCSWINSZ, &size);
+        fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+        // Terminal makes stdin non-blocking, which must not leak into whatever runs the tests
+        stdinCopy = dup(STDIN_FILENO);
+        auto null = open("/dev/null", O_RDONLY);
+        dup2(null, STDIN_FILENO);
+        close(null);
+    }
+    Pty(const Pty &) = delete;
+    Pty &operator=(const Pty &) = delete;
+    ~Pty()
+    {
+        dup2(stdinCopy, STDIN_FILENO);
+        close(stdinCopy);
+        close(slave);
+        close(master);
+    }
+
+    // What the terminal received so far
+    std::string read()
+    {
+        std::string data;
+        char chunk[4096];
+        ssize_t count;
+        while ((count = ::read(master, chunk, sizeof(chunk))) > 0) {
+            data.append(chunk, static_cast<std::size_t>(count));
+        }
+        return data;
+    }
+
+    int master;
+    int slave;
+
+  private:
+    int stdinCopy;
+};
+
+// A failed write on the output thread has to reach the caller, and the frames after it must still be written
+void outputThreadFailure()
+{
+    Pty pty;
+    // Written to in place of the pty: a read-only descriptor fails every write with EBADF
+    auto slaveCopy = dup(pty.slave);
+    auto readOnly = open("/dev/null", O_RDONLY);
+    {
+        Terminal terminal(pty.slave);
+        terminal.setOutputThread(true);
+        auto text = Text("first");
+        terminal.render(text);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        check(pty.read().find("first") != std::string::npos, "frames are written by the output thread");
+
+        dup2(readOnly, pty.slave);
+        bool thrown = false;
+        for (int frame = 0; frame < 100 && !thrown; ++frame) {
+            text->setText("frame " + std::to_string(frame));
+            try {
+                terminal.render(text);
+            } catch (const std::system_error &) {
+                thrown = true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        check(thrown, "the failed write is rethrown");
+        text->setText("still failing");
+        bool again = false;
+        try {
+            terminal.render(text);
+        } catch (const std::system_error &) {
+            again = true;
+        }
+        check(again, "later frames are written directly and fail as well");
+
+        dup2(slaveCopy, pty.slave);
+        pty.read();
+        text->setText("recovered");
+        terminal.render(text);
+        check(pty.read().find("recovered") != std::string::npos, "frames arrive again once the output works");
+    }
+    close(slaveCopy);
+    close(readOnly);
+}
+
+Register outputThreadTest("output_thread_failure", outputThreadFailure);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
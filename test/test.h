@@ -0,0 +1,37 @@
+#pragma once
+#include "tuilight/output.h"
+#include <cstdio>
+#include <source_location>
+#include <string>
+#include <string_view>
+
+namespace wibens::tuilight::test
+{
+
+// Reports a failed expectation and goes on, so a single run lists every failure
+bool check(bool condition, std::string_view what, std::source_location location = std::source_location::current());
+
+// Adds a test to the ones tuilight_test runs, meant for a static object next to the test function
+struct Register {
+    Register(std::string_view name, void (*run)());
+};
+
+// An OutputBuffer writing to a temporary file, so what reaches the fd can be read back
+class Capture
+{
+  public:
+    Capture();
+    Capture(const Capture &) = delete;
+    Capture &operator=(const Capture &) = delete;
+    ~Capture();
+
+    OutputBuffer &out() { return buffer; }
+    // Flushes out() and returns the bytes written since the last call
+    std::string take();
+
+  private:
+    std::FILE *file;
+    OutputBuffer buffer;
+};
+
+} // namespace wibens::tuilight::test
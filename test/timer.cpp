@@ -0,0 +1,94 @@
+#include "test.h"
+#include "tuilight/timer.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+// Compared with a list of deadlines, over delays that reach every level of the wheel and beyond
+void timerWheel()
+{
+    using Clock = std::chrono::steady_clock;
+    using std::chrono::milliseconds;
+    struct Expected {
+        long long deadline;
+        long long interval;
+    };
+    std::mt19937_64 rng(3);
+    auto origin = Clock::time_point{} + std::chrono::hours(1);
+    for (int round = 0; round < 20; ++round) {
+        TimerWheel<long long> wheel(origin);
+        std::map<TimerWheel<long long>::Id, Expected> expected;
+        std::vector<TimerWheel<long long>::Id> fired;
+        long long now = 0;
+        for (int step = 0; step < 300; ++step) {
+            auto op = rng() % 10;
+            if (op < 4) {
+                long long delays[] = {0, 1, 63, 64, 4095, 4096, 262143, 262144, 20000000};
+                long long delay =
+                    rng() % 2 ? delays[rng() % std::size(delays)] : static_cast<long long>(rng() % 300000);
+                long long interval = rng() % 3 == 0 ? 1 + static_cast<long long>(rng() % 100) : 0;
+                auto id = std::make_shared<TimerWheel<long long>::Id>();
+                *id = wheel.add(origin + milliseconds(now), milliseconds(delay),
+                                [&fired, id](long long) { fired.push_back(*id); }, milliseconds(interval));
+                check(*id != 0, "id");
+                expected[*id] = {now + std::max(delay, 1LL), interval};
+            } else if (op < 5 && !expected.empty()) {
+                auto it = std::next(expected.begin(), static_cast<long>(rng() % expected.size()));
+                check(wheel.cancel(it->first), "cancel");
+                check(!wheel.cancel(it->first), "cancel twice");
+                expected.erase(it);
+            } else {
+                auto next = wheel.nextDeadline();
+                long long earliest = std::numeric_limits<long long>::max();
+                for (auto &[id, timer] : expected) {
+                    earliest = std::min(earliest, timer.deadline);
+                }
+                if (!check(next.has_value() == !expected.empty(), "nextDeadline")) {
+                    continue;
+                }
+                if (next) {
+                    auto tick = std::chrono::duration_cast<milliseconds>(*next - origin).count();
+                    check(tick > now && tick <= earliest, "nextDeadline before the earliest timer");
+                    // Mostly jump from deadline to deadline, which walks through every cascade on the way
+                    now = rng() % 4 ? tick : now + static_cast<long long>(rng() % 100000);
+                }
+                fired.clear();
+                wheel.advance(origin + milliseconds(now), now);
+                std::vector<TimerWheel<long long>::Id> due;
+                for (auto &[id, timer] : expected) {
+                    if (timer.deadline <= now) {
+                        due.push_back(id);
+                    }
+                }
+                std::sort(fired.begin(), fired.end());
+                check(fired == due, "due timers fire once");
+                for (auto id : due) {
+                    auto &timer = expected[id];
+                    if (timer.interval == 0) {
+                        expected.erase(id);
+                    } else {
+                        timer.deadline += ((now - timer.deadline) / timer.interval + 1) * timer.interval;
+                    }
+                }
+                check(wheel.size() == expected.size(), "size");
+            }
+        }
+    }
+}
+
+Register timerWheelTest("timer_wheel", timerWheel);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
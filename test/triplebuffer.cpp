@@ -0,0 +1,60 @@
+#include "test.h"
+#include "tuilight/triplebuffer.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <thread>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+// The consumer only ever sees whole values, in the order they were published, and always gets the last one
+void tripleBufferHandoff()
+{
+    using Value = std::array<std::uint64_t, 32>;
+    constexpr std::uint64_t values = 200000;
+    TripleBuffer<Value> buffer;
+    std::thread producer([&buffer] {
+        for (std::uint64_t value = 1; value <= values; ++value) {
+            buffer.writeBuffer().fill(value);
+            buffer.publish();
+        }
+    });
+    std::uint64_t last = 0;
+    std::size_t received{};
+    bool whole = true;
+    bool ordered = true;
+    while (last < values) {
+        if (!buffer.update()) {
+            std::this_thread::yield();
+            continue;
+        }
+        const auto &value = buffer.readBuffer();
+        whole = whole && std::all_of(value.begin(), value.end(), [&value](auto v) { return v == value[0]; });
+        ordered = ordered && value[0] > last;
+        last = value[0];
+        ++received;
+    }
+    producer.join();
+    check(whole, "values are never torn");
+    check(ordered, "newer values replace older ones, never the other way around");
+    check(!buffer.update(), "nothing new after the last value");
+    check(received > 0 && received <= values, "received");
+
+    // Without a consumer in between, only the newest value is handed over
+    TripleBuffer<int> single;
+    for (int value = 1; value <= 3; ++value) {
+        single.writeBuffer() = value;
+        single.publish();
+    }
+    check(single.update() && single.readBuffer() == 3 && !single.update(), "the newest value wins");
+}
+
+Register tripleBufferTest("triple_buffer", tripleBufferHandoff);
+
+} // namespace
+
+} // namespace wibens::tuilight::test
@@ -0,0 +1,66 @@
+#include "test.h"
+#include "tuilight/unicode.h"
+#include <string>
+#include <string_view>
+
+namespace wibens::tuilight::test
+{
+
+namespace
+{
+
+void unicodeWidth()
+{
+    using unicode::width;
+    check(width(U'a') == 1 && width(U'\u00E9') == 1, "narrow");
+    check(width(U'\u0301') == 0 && width(U'\u200B') == 0, "combining and zero width");
+    check(width(U'世') == 2 && width(U'\U0001F600') == 2 && width(U'\uFF21') == 2, "wide and emoji");
+
+    using unicode::displayWidth;
+    check(displayWidth("plain ascii") == 11, "ascii");
+    check(displayWidth("世界") == 4 && displayWidth("a😀b") == 4, "wide characters");
+    check(displayWidth("e\u0301") == 1, "a combining mark adds nothing");
+    // Each byte of malformed input is shown as one U+FFFD
+    check(displayWidth("\xff\xfe") == 2, "invalid bytes");
+    check(displayWidth("a\xe4\xb8") == 3, "truncated sequence");
+    check(displayWidth("\xc0\xaf") == 2, "overlong encoding");
+    check(displayWidth("\xed\xa0\x80") == 3, "surrogate");
+
+    // The vectorized ASCII check has to find a single high byte anywhere, including the tail after the last full block
+    for (std::size_t length = 1; length < 80; ++length) {
+        std::string text(length, 'x');
+        check(unicode::isAscii(text), "all ascii");
+        for (std::size_t at = 0; at < length; ++at) {
+            text[at] = '\x80';
+            check(!unicode::isAscii(text), "high byte");
+            text[at] = 'x';
+        }
+    }
+
+    for (char32_t c : {U'a', U'\u00E9', U'\u0800', U'世', U'\uFFFD', U'\U0001F600', U'\U0010FFFF'}) {
+        char bytes[4];
+        auto length = unicode::encode(c, bytes);
+        std::size_t pos = 0;
+        check(unicode::decode(std::string_view(bytes, length), pos) == c && pos == length, "round trip");
+    }
+}
+
+void unicodeClip()
+{
+    using unicode::clip;
+    check(clip("abcdef", 3) == "abc", "ascii");
+    check(clip("ab", 5) == "ab", "shorter than the limit");
+    check(clip("世界", 3) == "世" && clip("世界", 4) == "世界", "wide characters are never split");
+    check(clip("ab世", 3) == "ab", "a wide character that does not fit");
+    check(clip("😀", 1).empty(), "nothing fits");
+    check(clip("e\u0301x", 1) == "e\u0301", "combining marks stay with their base");
+    check(clip("a\xff" "bc", 2) == "a\xff", "an invalid byte takes a column");
+    check(clip("\xe4\xb8\x96\xe4", 2) == "\xe4\xb8\x96", "a truncated sequence is cut off");
+}
+
+Register unicodeWidthTest("unicode_width", unicodeWidth);
+Register unicodeClipTest("unicode_clip", unicodeClip);
+
+} // namespace
+
+} // namespace wibens::tuilight::test